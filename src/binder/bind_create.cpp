@@ -129,7 +129,35 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // Included columns are given as `WITH (include = col, include = 'col', ...)`.
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto def_elem = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      if (std::string(def_elem->defname) != "include") {
+        throw NotImplementedException(fmt::format("unsupported index option {}", def_elem->defname));
+      }
+      std::string col_name;
+      if (def_elem->arg != nullptr && def_elem->arg->type == duckdb_libpgquery::T_PGString) {
+        col_name = reinterpret_cast<duckdb_libpgquery::PGValue *>(def_elem->arg)->val.str;
+      } else if (def_elem->arg != nullptr && def_elem->arg->type == duckdb_libpgquery::T_PGTypeName) {
+        auto names = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(def_elem->arg)->names;
+        col_name = reinterpret_cast<duckdb_libpgquery::PGValue *>(names->tail->data.ptr_value)->val.str;
+      } else {
+        throw bustub::Exception("include expects a column name");
+      }
+      auto column_ref = ResolveColumn(*table, std::vector{col_name});
+      include_cols.emplace_back(std::make_unique<BoundColumnRef>(dynamic_cast<const BoundColumnRef &>(*column_ref)));
+    }
+  }
+
+  // A unique index compares whole keys, so included columns would take part in the uniqueness.
+  if (stmt->unique && !include_cols.empty()) {
+    throw bustub::Exception("included columns are only supported on non-unique indexes");
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), std::move(include_cols),
+                                          stmt->unique);
 }
 
 }  // namespace bustub
@@ -12,7 +12,12 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <cstring>
+#include <new>
+
 #include "common/exception.h"
+#include "common/logger.h"
 #include "common/macros.h"
 #include "storage/page/page_guard.h"
 
@@ -20,196 +25,420 @@ namespace bustub {
 
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
                                      LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // TODO(students): remove this line after you have implemented the buffer pool manager
-  //  throw NotImplementedException(
-  //      "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
-  //      "exception line in `buffer_pool_manager.cpp`.");
-
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
+    : BufferPoolManager(pool_size, 1, 0, disk_manager, replacer_k, log_manager) {}
+
+BufferPoolManager::BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                     DiskManager *disk_manager, size_t replacer_k, LogManager *log_manager)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      frame_arena_(pool_size),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      page_table_(pool_size),
+      // a ring may use at most a quarter of the pool
+      scan_ring_size_(std::min<size_t>(SCAN_RING_SIZE, pool_size / 4)),
+      scan_owner_(pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(instance_index < num_instances,
+                "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should "
+                "just be 0.");
+
+  // we allocate a consecutive memory space for the buffer pool, the page data in the arena and the metadata here
+  pages_ = static_cast<Page *>(::operator new[](pool_size_ * sizeof(Page), std::align_val_t{alignof(Page)}));
+  for (size_t i = 0; i < pool_size_; ++i) {
+    new (&pages_[i]) Page(frame_arena_.FrameData(static_cast<frame_id_t>(i)));
+  }
   replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
     free_list_.emplace_back(static_cast<int>(i));
+    pages_[i].pin_count_ = -1;
   }
+
+  dirty_epoch_.assign(pool_size_, 0);
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+BufferPoolManager::~BufferPoolManager() {
+  StopBackgroundFlusher();
+  // wait for outstanding prefetches, they write into the frames
+  async_disk_manager_.reset();
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].~Page();
+  }
+  ::operator delete[](pages_, std::align_val_t{alignof(Page)});
+}
 
 auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
+  std::scoped_lock lock(latch_);
   frame_id_t frame_id;
-  bool is_evict = false;
-  // 从空闲列表中取得帧id
-  bool is_have_free_frame = GetFrameIDFromFreeList(frame_id);
-  // 没有空闲帧，
-  if (!is_have_free_frame) {
-    bool is_allocatable = IsAllocateFromReplacer();
+  // 从空闲列表或replacer中取得帧id
+  if (!AllocateFrameId(frame_id)) {
     // 没有可驱逐的帧
-    if (!is_allocatable) {
-      *page_id = INVALID_PAGE_ID;
-      return nullptr;
-    }
-    // 可驱逐的帧，将其驱逐并设定为不可驱逐
-    if(!replacer_->Evict(&frame_id)){
-      return nullptr;
-    }
-    is_evict= true;
-    replacer_->SetEvictable(frame_id, false);
-  }
-
-  // 是否需要刷盘
-  if (pages_[frame_id].is_dirty_) {
-    FlushPage(pages_[frame_id].page_id_);
+    *page_id = INVALID_PAGE_ID;
+    return nullptr;
   }
 
-  pages_[frame_id].ResetMemory();
-  pages_[frame_id].pin_count_ = 0;
-  pages_[frame_id].is_dirty_ = false;
-
   *page_id = AllocatePage();
-  page_table_[*page_id] = frame_id;
+  Page *page = &pages_[frame_id];
+  page->page_id_ = *page_id;
+  page->pin_count_ = 1;
+  page_table_.Insert(*page_id, frame_id);
 
   // record access
   replacer_->RecordAccess(frame_id);
   replacer_->SetEvictable(frame_id, false);
-  pages_[frame_id].pin_count_++;
-
-  if(is_evict){
-    page_table_.erase(pages_[frame_id].page_id_);
-  }
-  pages_[frame_id].page_id_ = *page_id;
-  return &pages_[frame_id];
+  return page;
 }
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
-  // 取得page 从freelist 或 replacer获得
-  auto iter = page_table_.find(page_id);
-  Page *fetch_page = nullptr;
-  frame_id_t frame_id = -1;
-  // 没有在页表中缓存，则需要将其缓存起来
-  if (iter == page_table_.end()) {
-    // 从freelist取得可食用frameId
-    frame_id = INVALID_PAGE_ID;
-    bool is_frame_id_allocatable = BufferPoolManager::AllocateFrameId(page_id, frame_id);
-    // 可分配 帧
-    if (!is_frame_id_allocatable) {
-      // 帧id无法被分配
-      return nullptr;
-    }
+auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type, BufferAccessStrategy *strategy)
+    -> Page * {
+  if (Page *page = TryPinUnlatched(page_id, access_type); page != nullptr) {
+    return page;
+  }
 
-    //
-    page_table_[page_id] = frame_id;
+  std::unique_lock lock(latch_);
+  frame_id_t frame_id = page_table_.Find(page_id);
+  while (frame_id != -1 && IsLoading(frame_id)) {
+    // another thread is reading the page in
+    io_cv_.wait(lock);
+    frame_id = page_table_.Find(page_id);
+  }
 
-    char page_content[BUSTUB_PAGE_SIZE];
-    disk_manager_->ReadPage(page_id, page_content);
-    memcpy(pages_[frame_id].data_, page_content, BUSTUB_PAGE_SIZE);
-  } else {
-    frame_id = iter->second;
+  if (frame_id != -1) {
+    // nothing can claim the frame while we hold the latch
+    pages_[frame_id].pin_count_++;
+    if (access_type != AccessType::Scan) {
+      // promoted out of its scan ring
+      scan_owner_[frame_id] = nullptr;
+    }
+    replacer_->RecordAccess(frame_id, access_type);
+    replacer_->SetEvictable(frame_id, false);
+    return &pages_[frame_id];
   }
 
-  // *pages_[frame_id].data_ = *page_content;
-  // pages_[frame_id].data_ = page_content;
-  // 更新被固定的个数
-  // frame_infos_[frame_id].pin_count++;
+  // 没有在页表中缓存，则需要将其缓存起来
+  bool is_allocated = strategy != nullptr && scan_ring_size_ > 0 ? AllocateScanFrameId(strategy, frame_id)
+                                                                 : AllocateFrameId(frame_id);
+  if (!is_allocated) {
+    // 帧id无法被分配
+    return nullptr;
+  }
 
-  replacer_->RecordAccess(frame_id);
+  // publish the page while its frame is still claimed, so that other fetches of page_id wait for the read instead
+  // of reading it a second time
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page_table_.Insert(page_id, frame_id);
+  replacer_->RecordAccess(frame_id, access_type);
   replacer_->SetEvictable(frame_id, false);
-  fetch_page = &pages_[frame_id];
-  pages_[frame_id].pin_count_++;
-  return fetch_page;
+
+  // the read does not hold up hits and misses on other pages
+  lock.unlock();
+  try {
+    disk_manager_->ReadPage(page_id, page->GetData());
+  } catch (...) {
+    lock.lock();
+    AbandonRead(frame_id, page_id);
+    lock.unlock();
+    io_cv_.notify_all();
+    throw;
+  }
+  lock.lock();
+
+  page->pin_count_ = 1;
+  lock.unlock();
+  io_cv_.notify_all();
+  return page;
 }
 
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
-  auto iter = page_table_.find(page_id);
-  // 在缓冲区池里没有 ，返回false
+  if (!is_dirty) {
+    // the caller's pin keeps the page in its frame, so dropping a pin that is not the last one needs no latch
+    frame_id_t frame_id = page_table_.Find(page_id);
+    if (frame_id != -1) {
+      int pin_count = pages_[frame_id].pin_count_;
+      while (pin_count > 1) {
+        if (pages_[frame_id].pin_count_.compare_exchange_weak(pin_count, pin_count - 1)) {
+          return true;
+        }
+      }
+    }
+  }
 
-  if (iter == page_table_.end()) {
+  std::scoped_lock lock(latch_);
+  frame_id_t frame_id = page_table_.Find(page_id);
+  // 在缓冲区池里没有 ，返回false
+  if (frame_id == -1) {
     return false;
   }
   // pin count 已经小于等于0
-  frame_id_t frame_id = iter->second;
   if (pages_[frame_id].pin_count_ <= 0) {
     return false;
   }
 
   if (is_dirty) {
-    pages_[frame_id].is_dirty_ = is_dirty;
-  }
-  pages_[frame_id].pin_count_--;
-  if (pages_[frame_id].pin_count_ == 0) {
-    replacer_->SetEvictable(frame_id, true);
+    SetDirty(frame_id, true);
+    dirty_epoch_[frame_id]++;
+    if (flusher_running_ && scan_owner_[frame_id] != nullptr) {
+      // the ring recycles the frame soon, write it before the scan has to; the flusher skips a frame it sees twice
+      dirty_ring_frames_.push_back(frame_id);
+      flusher_cv_.notify_one();
+    }
+    if (flusher_running_ && !flush_requested_ && num_dirty_ > flusher_high_dirty_) {
+      flush_requested_ = true;
+      flusher_cv_.notify_one();
+    }
   }
-
-  return true;
+  return UnpinFrame(frame_id);
 }
 
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  auto iter = page_table_.find(page_id);
+  std::scoped_lock lock(latch_);
+  frame_id_t frame_id = page_table_.Find(page_id);
   // 在页表中没有
-  if (iter == page_table_.end()) {
+  if (frame_id == -1) {
     return false;
   }
 
-  frame_id_t frame_id = iter->second;
-
-  disk_manager_->WritePage(page_id, pages_[frame_id].data_);
-  pages_[frame_id].is_dirty_ = false;
+  // a page that is still being read in is clean
+  if (!IsLoading(frame_id)) {
+    FlushFrame(frame_id);
+  }
   return true;
 }
 
 void BufferPoolManager::FlushAllPages() {
-  for (auto &iter : page_table_) {
-    FlushPage(iter.first);
+  std::scoped_lock lock(latch_);
+  for (size_t frame_id = 0; frame_id < pool_size_; frame_id++) {
+    if (pages_[frame_id].page_id_ != INVALID_PAGE_ID && !IsLoading(static_cast<frame_id_t>(frame_id))) {
+      FlushFrame(static_cast<frame_id_t>(frame_id));
+    }
   }
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
-  auto iter = page_table_.find(page_id);
-  if (iter == page_table_.end()) {
+  std::scoped_lock lock(latch_);
+  frame_id_t frame_id = page_table_.Find(page_id);
+  if (frame_id == -1) {
+    DeallocatePage(page_id);
     return true;
   }
 
-  frame_id_t frame_id = iter->second;
-  if (pages_[frame_id].pin_count_ > 0) {
+  if (!ClaimFrame(frame_id)) {
     return false;
   }
 
-  page_table_.erase(iter);
+  page_table_.Erase(page_id);
+  // a latch-free pin may have been taken and dropped since the frame last became evictable
+  replacer_->SetEvictable(frame_id, true);
+  replacer_->Remove(frame_id);
+  scan_owner_[frame_id] = nullptr;
   free_list_.push_back(frame_id);
   pages_[frame_id].ResetMemory();
-  pages_[frame_id].pin_count_ = 0;
-  pages_[frame_id].is_dirty_ = false;
+  SetDirty(frame_id, false);
   pages_[frame_id].page_id_ = INVALID_PAGE_ID;
-  replacer_->Remove(frame_id);
   DeallocatePage(page_id);
   return true;
 }
 
-auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
+void BufferPoolManager::PrefetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  std::scoped_lock lock(latch_);
+  if (page_table_.Find(page_id) != -1) {
+    // resident or already being read in
+    return;
+  }
+
+  frame_id_t frame_id;
+  bool is_allocated = strategy != nullptr && scan_ring_size_ > 0 ? AllocateScanFrameId(strategy, frame_id)
+                                                                 : AllocateFrameId(frame_id);
+  if (!is_allocated) {
+    return;
+  }
+
+  // the frame stays claimed until the read completes, exactly like a miss in FetchPage()
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page_table_.Insert(page_id, frame_id);
+  replacer_->RecordAccess(frame_id, AccessType::Scan);
+  replacer_->SetEvictable(frame_id, false);
+  GetAsyncDiskManager()->Submit({false, page->GetData(), page_id, {}, [this, frame_id, page_id](bool success) {
+                                   FinishPrefetch(frame_id, page_id, success);
+                                 }});
+}
+
+void BufferPoolManager::FinishPrefetch(frame_id_t frame_id, page_id_t page_id, bool success) {
+  {
+    std::scoped_lock lock(latch_);
+    if (success) {
+      // nobody holds a pin on the prefetched page yet
+      pages_[frame_id].pin_count_ = 0;
+      if (scan_owner_[frame_id] == nullptr) {
+        replacer_->SetEvictable(frame_id, true);
+      }
+    } else {
+      // pretend the prefetch never happened, a later fetch will read the page itself and see the error
+      AbandonRead(frame_id, page_id);
+    }
+  }
+  io_cv_.notify_all();
+}
+
+void BufferPoolManager::AbandonRead(frame_id_t frame_id, page_id_t page_id) {
+  page_table_.Erase(page_id);
+  replacer_->SetEvictable(frame_id, true);
+  replacer_->Remove(frame_id);
+  scan_owner_[frame_id] = nullptr;
+  pages_[frame_id].ResetMemory();
+  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+  // the frame is still claimed, as frames on the free list are
+  free_list_.push_back(frame_id);
+}
+
+auto BufferPoolManager::GetAsyncDiskManager() -> AsyncDiskManager * {
+  if (async_disk_manager_ == nullptr) {
+    async_disk_manager_ = std::make_unique<AsyncDiskManager>(disk_manager_);
+  }
+  return async_disk_manager_.get();
+}
+
+void BufferPoolManager::StartBackgroundFlusher(double high_watermark, double low_watermark) {
+  BUSTUB_ENSURE(0 <= low_watermark && low_watermark <= high_watermark && high_watermark <= 1,
+                "watermarks must satisfy 0 <= low <= high <= 1");
+  std::scoped_lock lock(latch_);
+  if (flusher_running_) {
+    return;
+  }
+  flusher_high_dirty_ = static_cast<size_t>(high_watermark * static_cast<double>(pool_size_));
+  flusher_low_dirty_ = static_cast<size_t>(low_watermark * static_cast<double>(pool_size_));
+  GetAsyncDiskManager();
+  flusher_running_ = true;
+  flush_requested_ = num_dirty_ > flusher_high_dirty_;
+  dirty_ring_frames_.clear();
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].is_dirty_ && scan_owner_[i] != nullptr) {
+      dirty_ring_frames_.push_back(static_cast<frame_id_t>(i));
+    }
+  }
+  flusher_thread_ = std::thread(&BufferPoolManager::BackgroundFlush, this);
+}
+
+void BufferPoolManager::StopBackgroundFlusher() {
+  {
+    std::scoped_lock lock(latch_);
+    if (!flusher_running_) {
+      return;
+    }
+    flusher_running_ = false;
+  }
+  flusher_cv_.notify_one();
+  flusher_thread_.join();
+}
+
+void BufferPoolManager::BackgroundFlush() {
+  std::unique_lock lock(latch_);
+  while (true) {
+    flusher_cv_.wait(lock, [this] { return !flusher_running_ || flush_requested_ || !dirty_ring_frames_.empty(); });
+    if (!flusher_running_) {
+      return;
+    }
+    bool flush_pool = flush_requested_;
+    flush_requested_ = false;
+    std::vector<frame_id_t> ring_frames;
+    ring_frames.swap(dirty_ring_frames_);
+    FlushCandidates(lock, ring_frames, 0);
+    if (flush_pool) {
+      FlushCandidates(lock, replacer_->EvictionCandidates(replacer_->Size()), flusher_low_dirty_);
+    }
+  }
+}
 
-auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard {
-  Page *page = BufferPoolManager::FetchPage(page_id, AccessType::Unknown);
+void BufferPoolManager::FlushCandidates(std::unique_lock<std::mutex> &lock, const std::vector<frame_id_t> &candidates,
+                                        size_t target_dirty) {
+  std::vector<std::pair<frame_id_t, uint64_t>> batch;
+  batch.reserve(FLUSHER_BATCH_SIZE);
+  std::vector<std::future<bool>> writes;
+  writes.reserve(FLUSHER_BATCH_SIZE);
+  auto buffer = std::make_unique<char[]>(FLUSHER_BATCH_SIZE * BUSTUB_PAGE_SIZE);
+  auto next = candidates.begin();
+  while (flusher_running_ && num_dirty_ > target_dirty && next != candidates.end()) {
+    batch.clear();
+    size_t batch_size = std::min<size_t>(FLUSHER_BATCH_SIZE, num_dirty_ - target_dirty);
+    for (; next != candidates.end() && batch.size() < batch_size; ++next) {
+      frame_id_t frame_id = *next;
+      Page &page = pages_[frame_id];
+      // the frame may have been pinned, evicted or written back since the candidates were collected
+      if (page.page_id_ == INVALID_PAGE_ID || page.pin_count_ != 0 || !page.is_dirty_) {
+        continue;
+      }
+      // pin the page so it cannot be evicted or deleted while it is written without the latch
+      page.pin_count_++;
+      replacer_->SetEvictable(frame_id, false);
+      batch.emplace_back(frame_id, dirty_epoch_[frame_id]);
+    }
+
+    lock.unlock();
+    writes.clear();
+    for (size_t i = 0; i < batch.size(); i++) {
+      Page &page = pages_[batch[i].first];
+      // write a copy, so that no page latch is held across the I/O and the writes of a batch overlap
+      char *copy = buffer.get() + i * BUSTUB_PAGE_SIZE;
+      page.RLatch();
+      memcpy(copy, page.GetData(), BUSTUB_PAGE_SIZE);
+      page.RUnlatch();
+      writes.push_back(async_disk_manager_->SubmitWrite(page.GetPageId(), copy));
+    }
+    std::vector<bool> written(batch.size());
+    for (size_t i = 0; i < batch.size(); i++) {
+      try {
+        written[i] = writes[i].get();
+      } catch (const Exception &e) {
+        LOG_WARN("background flush of page %d failed: %s", pages_[batch[i].first].GetPageId(), e.what());
+      }
+    }
+    lock.lock();
+
+    for (size_t i = 0; i < batch.size(); i++) {
+      auto [frame_id, epoch] = batch[i];
+      // a page unpinned dirty in the meantime may have been modified after it was copied, and a FlushPage() of the
+      // newer version may have landed before our write, so it has to stay dirty; so does a page whose write failed
+      SetDirty(frame_id, !written[i] || dirty_epoch_[frame_id] != epoch);
+      UnpinFrame(frame_id);
+    }
+  }
+}
+
+auto BufferPoolManager::AllocatePage() -> page_id_t {
+  return disk_manager_->AllocatePage(num_instances_, instance_index_);
+}
+
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id, AccessType access_type, BufferAccessStrategy *strategy)
+    -> BasicPageGuard {
+  Page *page = FetchPage(page_id, access_type, strategy);
   if (page == nullptr) {
     return {this, nullptr};
   }
   return {this, page};
 }
 
-auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
-  Page *page = BufferPoolManager::FetchPage(page_id, AccessType::Unknown);
+auto BufferPoolManager::FetchPageRead(page_id_t page_id, AccessType access_type, BufferAccessStrategy *strategy)
+    -> ReadPageGuard {
+  Page *page = FetchPage(page_id, access_type, strategy);
   if (page == nullptr) {
     return {this, nullptr};
   }
+  page->RLatch();
   return {this, page};
 }
 
-auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
-  Page *page = BufferPoolManager::FetchPage(page_id, AccessType::Unknown);
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id, AccessType access_type, BufferAccessStrategy *strategy)
+    -> WritePageGuard {
+  Page *page = FetchPage(page_id, access_type, strategy);
   if (page == nullptr) {
     return {this, nullptr};
   }
+  page->WLatch();
   return {this, page};
 }
 
@@ -221,42 +450,204 @@ auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard {
 
   return {this, page};
 }
-auto BufferPoolManager::AllocateFrameId(page_id_t page_id, frame_id_t &frame_id) -> bool {
-  // 无可分配
-  if (free_list_.empty()) {
-    frame_id_t evicted_frame_id;
-    bool res = replacer_->Evict(&evicted_frame_id);
-    if (!res) {
-      frame_id = -1;
-      return false;
-    }
-    page_table_.erase(pages_[evicted_frame_id].page_id_);
-    frame_id = evicted_frame_id;
-    // if page is dirty then flush page and reset pin count;
-    if (pages_[frame_id].is_dirty_) {
-      FlushPage(pages_[frame_id].page_id_);
-      pages_[frame_id].ResetMemory();
-      pages_[frame_id].page_id_ = page_id;
-      pages_[frame_id].pin_count_ = 0;
-      pages_[frame_id].is_dirty_ = false;
-    }
+
+auto BufferPoolManager::AllocateFrameId(frame_id_t &frame_id) -> bool {
+  if (GetFrameIDFromFreeList(frame_id)) {
     return true;
   }
-  frame_id = free_list_.front();
-  free_list_.pop_front();
-  return true;
-}
 
-auto BufferPoolManager::IsAllocateFromReplacer() -> bool {
+  // 无空闲帧，从replacer中驱逐
+  while (replacer_->Evict(&frame_id)) {
+    if (ClaimFrame(frame_id)) {
+      ResetFrame(frame_id);
+      return true;
+    }
+    // the victim was pinned by a latch-free hit after it became evictable, track it as a pinned frame again
+    replacer_->RecordAccess(frame_id);
+    replacer_->SetEvictable(frame_id, false);
+  }
+
+  // the replacer never sees the frames of scan rings, so their unpinned pages are the last resort before failing; the
+  // ring that loses its frame notices by the owner and refills the slot with the next miss that reaches it
   for (size_t i = 0; i < pool_size_; i++) {
-    if (pages_[i].pin_count_ == 0) {
+    auto ring_frame_id = static_cast<frame_id_t>(i);
+    if (scan_owner_[ring_frame_id] != nullptr && RecycleRingFrame(ring_frame_id)) {
+      frame_id = ring_frame_id;
       return true;
     }
   }
 
+  frame_id = -1;
   return false;
 }
 
+auto BufferPoolManager::AllocateScanFrameId(BufferAccessStrategy *strategy, frame_id_t &frame_id) -> bool {
+  if (strategy->rings_.size() < num_instances_) {
+    strategy->rings_.resize(num_instances_);
+  }
+  auto &ring = strategy->rings_[instance_index_];
+  if (ring.bpm_ == nullptr) {
+    ring.bpm_ = this;
+    ring.frames_.assign(scan_ring_size_, -1);
+  }
+
+  // slots from pos_ on hold the oldest pages of the ring; one whose frame went to another ring is empty
+  size_t ring_size = ring.frames_.size();
+  size_t slot = ring.pos_;
+  frame_id_t slot_frame_id = ring.frames_[slot];
+  bool slot_owned = slot_frame_id != -1 && scan_owner_[slot_frame_id] == strategy;
+  if (slot_owned && !RecycleRingFrame(slot_frame_id)) {
+    // the page of the slot is pinned, e.g. the scan's current page or a page another thread fetched
+    slot_owned = false;
+    for (size_t i = 1; i < ring_size; i++) {
+      size_t other = (ring.pos_ + i) % ring_size;
+      frame_id_t other_frame_id = ring.frames_[other];
+      if (other_frame_id != -1 && scan_owner_[other_frame_id] == strategy && RecycleRingFrame(other_frame_id)) {
+        slot = other;
+        slot_owned = true;
+        break;
+      }
+    }
+    if (!slot_owned) {
+      // every page of the ring is pinned, the page of the next slot leaves the ring and becomes evictable once unpinned
+      scan_owner_[slot_frame_id] = nullptr;
+    }
+  }
+
+  if (slot_owned) {
+    // recycle the frame of an earlier page of this scan instead of evicting someone else's page
+    frame_id = ring.frames_[slot];
+  } else if (!AllocateFrameId(frame_id)) {
+    return false;
+  }
+
+  ring.frames_[slot] = frame_id;
+  ring.pos_ = (slot + 1) % ring_size;
+  scan_owner_[frame_id] = strategy;
+  return true;
+}
+
+auto BufferPoolManager::RecycleRingFrame(frame_id_t frame_id) -> bool {
+  if (!ClaimFrame(frame_id)) {
+    return false;
+  }
+  replacer_->SetEvictable(frame_id, true);
+  replacer_->Remove(frame_id);
+  ResetFrame(frame_id);
+  return true;
+}
+
+void BufferPoolManager::ReleaseScanRing(BufferAccessStrategy *strategy) {
+  std::scoped_lock lock(latch_);
+  for (frame_id_t frame_id : strategy->rings_[instance_index_].frames_) {
+    if (frame_id == -1 || scan_owner_[frame_id] != strategy) {
+      continue;
+    }
+    scan_owner_[frame_id] = nullptr;
+    // pinned pages become evictable when they are unpinned, pages still being read in when the read completes
+    if (pages_[frame_id].pin_count_ == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+}
+
+void BufferPoolManager::ResetFrame(frame_id_t frame_id) {
+  Page *victim = &pages_[frame_id];
+  // if page is dirty then flush page
+  if (victim->is_dirty_) {
+    try {
+      FlushFrame(frame_id);
+    } catch (...) {
+      // keep the dirty page where it was, unpinned, and let the allocation fail with the write error
+      victim->pin_count_ = 0;
+      if (scan_owner_[frame_id] != nullptr) {
+        replacer_->RecordAccess(frame_id, AccessType::Scan);
+        replacer_->SetEvictable(frame_id, false);
+      } else {
+        replacer_->RecordAccess(frame_id);
+        replacer_->SetEvictable(frame_id, true);
+      }
+      throw;
+    }
+  }
+  page_table_.Erase(victim->page_id_);
+  victim->ResetMemory();
+  victim->page_id_ = INVALID_PAGE_ID;
+  scan_owner_[frame_id] = nullptr;
+}
+
+auto BufferPoolManager::TryPinUnlatched(page_id_t page_id, AccessType access_type) -> Page * {
+  frame_id_t frame_id = page_table_.Find(page_id);
+  if (frame_id == -1) {
+    return nullptr;
+  }
+
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_;
+  do {
+    if (pin_count < 0) {
+      // the frame is being replaced
+      return nullptr;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+
+  // our pin keeps the frame from being claimed, so if it still holds page_id now, it will until we unpin
+  if (page_table_.Find(page_id) != frame_id) {
+    std::scoped_lock lock(latch_);
+    UnpinFrame(frame_id);
+    return nullptr;
+  }
+
+  if (access_type != AccessType::Scan && scan_owner_[frame_id].load(std::memory_order_relaxed) != nullptr) {
+    // promoted out of its scan ring
+    scan_owner_[frame_id] = nullptr;
+  }
+  replacer_->TryRecordAccess(frame_id, access_type);
+  return page;
+}
+
+auto BufferPoolManager::IsLoading(frame_id_t frame_id) -> bool {
+  return pages_[frame_id].page_id_ != INVALID_PAGE_ID && pages_[frame_id].pin_count_ < 0;
+}
+
+auto BufferPoolManager::ClaimFrame(frame_id_t frame_id) -> bool {
+  int pin_count = 0;
+  return pages_[frame_id].pin_count_.compare_exchange_strong(pin_count, -1);
+}
+
+auto BufferPoolManager::UnpinFrame(frame_id_t frame_id) -> bool {
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_;
+  do {
+    if (pin_count <= 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+
+  // frames of a scan ring are only ever recycled through the ring, so that the replacer does not pick prefetched
+  // pages of a running scan (which have a single access) as victims before they are scanned
+  if (pin_count == 1 && scan_owner_[frame_id] == nullptr) {
+    replacer_->SetEvictable(frame_id, true);
+  }
+  return true;
+}
+
+void BufferPoolManager::FlushFrame(frame_id_t frame_id) {
+  disk_manager_->WritePage(pages_[frame_id].page_id_, pages_[frame_id].GetData());
+  SetDirty(frame_id, false);
+}
+
+void BufferPoolManager::SetDirty(frame_id_t frame_id, bool is_dirty) {
+  if (pages_[frame_id].is_dirty_ != is_dirty) {
+    pages_[frame_id].is_dirty_ = is_dirty;
+    if (is_dirty) {
+      num_dirty_++;
+    } else {
+      num_dirty_--;
+    }
+  }
+}
+
 auto BufferPoolManager::GetFrameIDFromFreeList(frame_id_t &frame_id) -> bool {
   if (free_list_.empty()) {
     frame_id = -1;
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "common/exception.h"
+
+#if defined(__SANITIZE_ADDRESS__)
+#define BUSTUB_ASAN_ENABLED 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define BUSTUB_ASAN_ENABLED 1
+#endif
+#endif
+
+#ifdef BUSTUB_ASAN_ENABLED
+#include <sanitizer/asan_interface.h>
+#endif
+
+namespace bustub {
+
+namespace {
+
+#ifdef BUSTUB_ASAN_ENABLED
+constexpr size_t FRAME_STRIDE = 2 * BUSTUB_PAGE_SIZE;
+#else
+constexpr size_t FRAME_STRIDE = BUSTUB_PAGE_SIZE;
+#endif
+
+auto RoundUp(size_t size, size_t alignment) -> size_t { return (size + alignment - 1) / alignment * alignment; }
+
+}  // namespace
+
+FrameArena::FrameArena(size_t num_frames) : stride_(FRAME_STRIDE) {
+  if (num_frames == 0) {
+    return;
+  }
+  size_ = RoundUp(num_frames * stride_, BUSTUB_PAGE_SIZE);
+
+#ifdef MAP_HUGETLB
+  if (size_ >= BUSTUB_HUGE_PAGE_SIZE) {
+    size_t huge_size = RoundUp(size_, BUSTUB_HUGE_PAGE_SIZE);
+    void *addr = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (addr != MAP_FAILED) {
+      // fails unless the administrator reserved huge pages, which is the common case
+      size_ = huge_size;
+      base_ = static_cast<char *>(addr);
+      kind_ = Kind::HUGE_TLB;
+    }
+  }
+#endif
+
+  if (base_ == nullptr) {
+    void *addr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr != MAP_FAILED) {
+      base_ = static_cast<char *>(addr);
+      kind_ = Kind::MMAP;
+#ifdef MADV_HUGEPAGE
+      if (size_ >= BUSTUB_HUGE_PAGE_SIZE) {
+        // only a hint, transparent huge pages may be disabled
+        madvise(base_, size_, MADV_HUGEPAGE);
+      }
+#endif
+    }
+  }
+
+  if (base_ == nullptr) {
+    base_ = static_cast<char *>(std::aligned_alloc(BUSTUB_PAGE_SIZE, size_));
+    if (base_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate buffer pool frames");
+    }
+    // anonymous mappings are zeroed, the heap is not
+    memset(base_, 0, size_);
+    kind_ = Kind::HEAP;
+  }
+
+#ifdef BUSTUB_ASAN_ENABLED
+  for (size_t i = 0; i < num_frames; i++) {
+    ASAN_POISON_MEMORY_REGION(base_ + i * stride_ + BUSTUB_PAGE_SIZE, stride_ - BUSTUB_PAGE_SIZE);
+  }
+#endif
+}
+
+FrameArena::~FrameArena() {
+  if (base_ == nullptr) {
+    return;
+  }
+#ifdef BUSTUB_ASAN_ENABLED
+  ASAN_UNPOISON_MEMORY_REGION(base_, size_);
+#endif
+  if (kind_ == Kind::HEAP) {
+    std::free(base_);
+  } else {
+    munmap(base_, size_);
+  }
+}
+
+}  // namespace bustub
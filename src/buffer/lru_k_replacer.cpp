@@ -11,140 +11,216 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/lru_k_replacer.h"
+
+#include <algorithm>
+#include <queue>
+
 #include "common/exception.h"
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : node_store_(num_frames), history_(num_frames * k), replacer_size_(num_frames), k_(k) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+  cold_heap_.reserve(num_frames);
+  hot_heap_.reserve(num_frames);
+}
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
-
-  bool res = false;
-  size_t max_kth_distance = 0;                  // init max distance
-  size_t earliest_frame_time = INT64_MAX;
-
-  latch_.lock();
-  size_t current_time = GetCurrentTimeStamp();  //
-  // loop frame map to get max kth distance
-  for (auto &iter : node_store_) {
-    LRUKNode node = iter.second;
-    if (node.IsEvictable()) {
-      if (node.GetK() < k_) {
-        max_kth_distance = INT64_MAX;
-        if (earliest_frame_time > node.GetHistory().front()) {
-          earliest_frame_time = node.GetHistory().front();
-          *frame_id = iter.first;
-          res = true;
-        }
-      } else if (max_kth_distance < (current_time - node.GetHistory().front())) {
-        max_kth_distance = current_time - node.GetHistory().front();
-        *frame_id = iter.first;
-        res = true;
-      }
-    }
+  std::scoped_lock lock(latch_);
+  // frames with +inf backward k-distance go first, oldest first access first
+  FrameHeap &heap = cold_heap_.empty() ? hot_heap_ : cold_heap_;
+  if (heap.empty()) {
+    return false;
   }
 
-  if (res) {
-    latch_.unlock();
-    Remove(*frame_id);
-    return true;
-  }
-  latch_.unlock();
-  return false;
+  *frame_id = heap.front();
+  HeapErase(heap, *frame_id);
+  node_store_[*frame_id] = LRUKNode{};
+  curr_size_--;
+  return true;
 }
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {
-  latch_.lock();
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
+  std::scoped_lock lock(latch_);
+  RecordAccessLocked(frame_id, access_type);
+}
 
-  if (replacer_size_ < static_cast<size_t>(frame_id)) {
-    latch_.unlock();
-    throw std::runtime_error("frame id is invalid.");
+auto LRUKReplacer::TryRecordAccess(frame_id_t frame_id, AccessType access_type) -> bool {
+  std::unique_lock lock(latch_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return false;
   }
+  RecordAccessLocked(frame_id, access_type);
+  return true;
+}
 
-  auto iter = node_store_.find(frame_id);
-  // 在replacer中不存在则新追加
-  if (iter == node_store_.end()) {
-    //  如果不在缓存池中则追加
-    LRUKNode node;
-    node.SetFid(frame_id);
-    node.AddOneToK();
-    node.SetIsEvictable(true);
-    std::list<size_t> hist{GetCurrentTimeStamp()};
-    node.SetHistory(hist);
-    node_store_[frame_id] = node;
-    curr_size_++;
-  } else {
-    // 存在则，更新第更新时间戳
-    LRUKNode node = iter->second;
-    // check k
-    if (node.GetK() < k_) {
-      node.AddOneToK();
-      node.GetHistory().push_back(GetCurrentTimeStamp());
-    } else {
-      node.GetHistory().pop_front();
-      node.GetHistory().push_back(GetCurrentTimeStamp());
+void LRUKReplacer::RecordAccessLocked(frame_id_t frame_id, AccessType access_type) {
+  CheckFrameId(frame_id);
+
+  LRUKNode &node = node_store_[frame_id];
+  if (access_type == AccessType::Scan && node.is_tracked_) {
+    // scans touch every page once, do not let them promote a page
+    return;
+  }
+  size_t *history = &history_[static_cast<size_t>(frame_id) * k_];
+  size_t timestamp = current_timestamp_++;
+  node.is_tracked_ = true;
+
+  if (node.k_ < k_) {
+    // history is not full yet, the oldest entry stays the first access
+    history[node.k_++] = timestamp;
+    node.kth_timestamp_ = history[0];
+    if (node.k_ == k_ && node.is_evictable_) {
+      // the frame now has a finite backward k-distance
+      HeapErase(cold_heap_, frame_id);
+      HeapPush(hot_heap_, frame_id);
     }
-    node_store_[frame_id] = node;
+    return;
+  }
+
+  // overwrite the oldest timestamp, the next slot becomes the k-th most recent access
+  history[node.head_] = timestamp;
+  node.head_ = (node.head_ + 1) % k_;
+  node.kth_timestamp_ = history[node.head_];
+  if (node.is_evictable_) {
+    // the key only ever grows, so the frame can only move down
+    HeapSiftDown(hot_heap_, node.heap_pos_);
   }
-  latch_.unlock();
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
-  latch_.lock();
+  std::scoped_lock lock(latch_);
+  CheckFrameId(frame_id);
 
-  auto iter = node_store_.find(frame_id);
-  if (iter == node_store_.end()) {
-    latch_.unlock();
+  LRUKNode &node = node_store_[frame_id];
+  if (!node.is_tracked_ || node.is_evictable_ == set_evictable) {
     return;
   }
-  LRUKNode node = iter->second;
-  if (node.IsEvictable() && !set_evictable) {
-    curr_size_--;
-  } else if (!node.IsEvictable() && set_evictable) {
+
+  node.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    HeapPush(HeapOf(frame_id), frame_id);
     curr_size_++;
+  } else {
+    HeapErase(HeapOf(frame_id), frame_id);
+    curr_size_--;
   }
-
-  node.SetIsEvictable(set_evictable);
-  node_store_[frame_id] = node;
-  latch_.unlock();
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
-  latch_.lock();
+  std::scoped_lock lock(latch_);
+  CheckFrameId(frame_id);
 
-  auto iter = node_store_.find(frame_id);
-  if (iter == node_store_.end()) {
-    latch_.unlock();
+  LRUKNode &node = node_store_[frame_id];
+  if (!node.is_tracked_) {
     return;
   }
-
-  if (!iter->second.IsEvictable()) {
-    latch_.unlock();
+  if (!node.is_evictable_) {
     throw std::runtime_error("Can't remove inevitable frame/");
   }
-  node_store_.erase(iter);
+
+  HeapErase(HeapOf(frame_id), frame_id);
+  node = LRUKNode{};
   curr_size_--;
-  latch_.unlock();
 }
 
-auto LRUKReplacer::Size() -> size_t { return curr_size_; }
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return curr_size_;
+}
+
+auto LRUKReplacer::EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> {
+  std::scoped_lock lock(latch_);
+  std::vector<frame_id_t> candidates;
+  candidates.reserve(std::min(max_count, curr_size_));
+  for (FrameHeap *heap : {&cold_heap_, &hot_heap_}) {
+    // best-first walk from the root: a position is only reachable once its parent has been emitted
+    auto later = [this, heap](size_t lhs, size_t rhs) {
+      return node_store_[(*heap)[lhs]].kth_timestamp_ > node_store_[(*heap)[rhs]].kth_timestamp_;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> frontier(later);
+    if (!heap->empty()) {
+      frontier.push(0);
+    }
+    while (!frontier.empty() && candidates.size() < max_count) {
+      size_t pos = frontier.top();
+      frontier.pop();
+      candidates.push_back((*heap)[pos]);
+      for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap->size(); child++) {
+        frontier.push(child);
+      }
+    }
+  }
+  return candidates;
+}
+
+void LRUKReplacer::CheckFrameId(frame_id_t frame_id) const {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+    throw std::runtime_error("frame id is invalid.");
+  }
+}
 
-auto LRUKReplacer::GetCurrentTimeStamp() -> size_t {
-  // Convert the system time to a time_t object
-  size_t current_time = std::chrono::duration_cast<std::chrono::microseconds>(
-                            std::chrono::high_resolution_clock::now().time_since_epoch())
-                            .count();
+auto LRUKReplacer::HeapOf(frame_id_t frame_id) -> FrameHeap & {
+  return node_store_[frame_id].k_ < k_ ? cold_heap_ : hot_heap_;
+}
 
-  return static_cast<size_t>(current_time);
+void LRUKReplacer::HeapSet(FrameHeap &heap, size_t pos, frame_id_t frame_id) {
+  heap[pos] = frame_id;
+  node_store_[frame_id].heap_pos_ = pos;
+}
+
+void LRUKReplacer::HeapPush(FrameHeap &heap, frame_id_t frame_id) {
+  heap.push_back(frame_id);
+  node_store_[frame_id].heap_pos_ = heap.size() - 1;
+  HeapSiftUp(heap, heap.size() - 1);
+}
+
+void LRUKReplacer::HeapErase(FrameHeap &heap, frame_id_t frame_id) {
+  size_t pos = node_store_[frame_id].heap_pos_;
+  frame_id_t last = heap.back();
+  heap.pop_back();
+  if (pos == heap.size()) {
+    return;
+  }
+  HeapSet(heap, pos, last);
+  HeapSiftUp(heap, pos);
+  HeapSiftDown(heap, node_store_[last].heap_pos_);
+}
+
+void LRUKReplacer::HeapSiftUp(FrameHeap &heap, size_t pos) {
+  frame_id_t frame_id = heap[pos];
+  size_t key = node_store_[frame_id].kth_timestamp_;
+  while (pos > 0) {
+    size_t parent = (pos - 1) / 2;
+    if (node_store_[heap[parent]].kth_timestamp_ <= key) {
+      break;
+    }
+    HeapSet(heap, pos, heap[parent]);
+    pos = parent;
+  }
+  HeapSet(heap, pos, frame_id);
+}
+
+void LRUKReplacer::HeapSiftDown(FrameHeap &heap, size_t pos) {
+  frame_id_t frame_id = heap[pos];
+  size_t key = node_store_[frame_id].kth_timestamp_;
+  while (true) {
+    size_t child = 2 * pos + 1;
+    if (child >= heap.size()) {
+      break;
+    }
+    if (child + 1 < heap.size() &&
+        node_store_[heap[child + 1]].kth_timestamp_ < node_store_[heap[child]].kth_timestamp_) {
+      child++;
+    }
+    if (key <= node_store_[heap[child]].kth_timestamp_) {
+      break;
+    }
+    HeapSet(heap, pos, heap[child]);
+    pos = child;
+  }
+  HeapSet(heap, pos, frame_id);
 }
 
-auto LRUKNode::GetHistory() -> std::list<size_t> & { return history_; }
-void LRUKNode::SetHistory(const std::list<size_t> &history) { history_ = history; }
-auto LRUKNode::GetK() const -> size_t { return k_; }
-void LRUKNode::SetK(size_t k) { k_ = k; }
-auto LRUKNode::GetFid() const -> frame_id_t { return fid_; }
-void LRUKNode::SetFid(frame_id_t fid) { fid_ = fid; }
-auto LRUKNode::IsEvictable() const -> bool { return is_evictable_; }
-void LRUKNode::SetIsEvictable(bool isEvictable) { is_evictable_ = isEvictable; }
-void LRUKNode::AddOneToK() { k_++; }
 }  // namespace bustub
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+namespace bustub {
+
+PageTable::PageTable(size_t num_frames) {
+  // keep the load factor at or below 1/2 so probe sequences stay short and an empty slot always exists
+  int bits = 1;
+  while ((static_cast<size_t>(1) << bits) < 2 * num_frames) {
+    bits++;
+  }
+  capacity_ = static_cast<size_t>(1) << bits;
+  mask_ = capacity_ - 1;
+  shift_ = 64 - bits;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+auto PageTable::HomeSlot(page_id_t page_id) const -> size_t {
+  // Fibonacci hashing spreads the sequential (and strided, in a parallel pool) page ids over the whole table
+  return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >>
+                             shift_);
+}
+
+auto PageTable::Find(page_id_t page_id) const -> frame_id_t {
+  size_t pos = HomeSlot(page_id);
+  // bounded, a reader racing with shifting writers must not probe forever
+  for (size_t probes = 0; probes < capacity_; probes++) {
+    uint64_t entry = slots_[pos].load(std::memory_order_acquire);
+    if (entry == EMPTY_SLOT) {
+      return -1;
+    }
+    if (PageIdOf(entry) == page_id) {
+      return FrameIdOf(entry);
+    }
+    pos = (pos + 1) & mask_;
+  }
+  return -1;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(size_ + 1 < capacity_, "page table is full");
+  size_t pos = HomeSlot(page_id);
+  while (slots_[pos].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+    BUSTUB_ASSERT(PageIdOf(slots_[pos].load(std::memory_order_relaxed)) != page_id, "page is already in the table");
+    pos = (pos + 1) & mask_;
+  }
+  slots_[pos].store(MakeEntry(page_id, frame_id), std::memory_order_release);
+  size_++;
+}
+
+void PageTable::Erase(page_id_t page_id) {
+  size_t hole = HomeSlot(page_id);
+  while (true) {
+    uint64_t entry = slots_[hole].load(std::memory_order_relaxed);
+    if (entry == EMPTY_SLOT) {
+      return;
+    }
+    if (PageIdOf(entry) == page_id) {
+      break;
+    }
+    hole = (hole + 1) & mask_;
+  }
+
+  // backward shift deletion: move every later entry of the cluster that may not live behind the hole into it
+  for (size_t pos = (hole + 1) & mask_;; pos = (pos + 1) & mask_) {
+    uint64_t entry = slots_[pos].load(std::memory_order_relaxed);
+    if (entry == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = HomeSlot(PageIdOf(entry));
+    // the entry can fill the hole unless its home lies cyclically in (hole, pos]
+    if (((pos - home) & mask_) >= ((pos - hole) & mask_)) {
+      slots_[hole].store(entry, std::memory_order_release);
+      hole = pos;
+    }
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  size_--;
+}
+
+}  // namespace bustub
@@ -1,6 +1,7 @@
 // DDL (Data Definition Language) statement handling in BusTub, including create table, create index, and set/show
 // variable.
 
+#include <algorithm>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -52,12 +53,18 @@ void BustubInstance::HandleCreateStatement(Transaction *txn, const CreateStateme
 }
 
 void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement &stmt, ResultWriter &writer) {
+  // The included columns follow the search key columns in the index key.
   std::vector<uint32_t> col_ids;
-  for (const auto &col : stmt.cols_) {
-    auto idx = stmt.table_->schema_.GetColIdx(col->col_name_.back());
-    col_ids.push_back(idx);
-    if (stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-      throw NotImplementedException("only support creating index on integer column");
+  for (const auto *cols : {&stmt.cols_, &stmt.include_cols_}) {
+    for (const auto &col : *cols) {
+      auto idx = stmt.table_->schema_.GetColIdx(col->col_name_.back());
+      if (std::find(col_ids.begin(), col_ids.end(), idx) != col_ids.end()) {
+        throw bustub::Exception("index column listed twice");
+      }
+      col_ids.push_back(idx);
+      if (stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
+        throw NotImplementedException("only support creating index on integer column");
+      }
     }
   }
   auto key_schema = Schema::CopySchema(&stmt.table_->schema_, col_ids);
@@ -74,7 +81,7 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
   auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
       txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
-      IntegerHashFunctionType{});
+      IntegerHashFunctionType{}, stmt.is_unique_, stmt.include_cols_.size());
   l.unlock();
 
   if (info == nullptr) {
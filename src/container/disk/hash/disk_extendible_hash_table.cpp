@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -22,11 +23,15 @@
 
 namespace bustub {
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+                                         const KeyComparator &comparator, HashFn hash_fn,
+                                         uint32_t header_depth)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+  BUSTUB_ENSURE((1U << header_depth) <= DIRECTORY_HEADER_ARRAY_SIZE, "hash table header depth too large");
+  BasicPageGuard header_guard = buffer_pool_manager_->NewPageGuarded(&header_page_id_);
+  BUSTUB_ENSURE(header_guard.GetDataMut() != nullptr, "no frame for the hash table header page");
+  header_guard.AsMut<HashTableDirectoryHeaderPage>()->Init(header_depth);
 }
 
 /*****************************************************************************
@@ -39,89 +44,241 @@ HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolMana
  * @param key the key to hash
  * @return the downcasted 32-bit hash
  */
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
   return static_cast<uint32_t>(hash_fn_.GetHash(key));
 }
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
-inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, const HashTableDirectoryPage *dir_page) -> uint32_t {
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
-inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, const HashTableDirectoryPage *dir_page) -> page_id_t {
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
-}
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+auto HASH_TABLE_TYPE::KeyToDirectoryPageId(const KeyType &key, bool create) -> page_id_t {
+  uint32_t directory_idx;
+  {
+    ReadPageGuard header_guard = buffer_pool_manager_->FetchPageRead(header_page_id_);
+    auto *header_page = header_guard.As<HashTableDirectoryHeaderPage>();
+    directory_idx = header_page->HashToDirectoryIndex(Hash(key));
+    page_id_t directory_page_id = header_page->GetDirectoryPageId(directory_idx);
+    // Directories are never freed, so the header need not stay latched once the page id is known.
+    if (directory_page_id != INVALID_PAGE_ID || !create) {
+      return directory_page_id;
+    }
+  }
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+  WritePageGuard header_guard = buffer_pool_manager_->FetchPageWrite(header_page_id_);
+  auto *header_page = header_guard.AsMut<HashTableDirectoryHeaderPage>();
+  page_id_t directory_page_id = header_page->GetDirectoryPageId(directory_idx);
+  if (directory_page_id != INVALID_PAGE_ID) {
+    return directory_page_id;
+  }
+  // A directory of global depth 0 with a single, empty bucket.
+  BasicPageGuard directory_guard = buffer_pool_manager_->NewPageGuarded(&directory_page_id);
+  BUSTUB_ENSURE(directory_guard.GetDataMut() != nullptr, "no frame for the hash table directory page");
+  page_id_t bucket_page_id;
+  BasicPageGuard bucket_guard = buffer_pool_manager_->NewPageGuarded(&bucket_page_id);
+  BUSTUB_ENSURE(bucket_guard.GetDataMut() != nullptr, "no frame for the hash table bucket page");
+  auto *dir_page = directory_guard.AsMut<HashTableDirectoryPage>();
+  dir_page->SetPageId(directory_page_id);
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+  header_page->SetDirectoryPageId(directory_idx, directory_page_id);
+  return directory_page_id;
 }
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  page_id_t directory_page_id = KeyToDirectoryPageId(key, false);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  ReadPageGuard directory_guard = buffer_pool_manager_->FetchPageRead(directory_page_id);
+  ReadPageGuard bucket_guard =
+      buffer_pool_manager_->FetchPageRead(KeyToPageId(key, directory_guard.As<HashTableDirectoryPage>()));
+  // Once the bucket is latched it cannot be split or merged, so the directory can be released.
+  directory_guard.Drop();
+  return bucket_guard.As<HASH_TABLE_BUCKET_TYPE>()->GetValue(key, Hash(key), comparator_, result);
 }
 
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  {
+    ReadPageGuard directory_guard = buffer_pool_manager_->FetchPageRead(KeyToDirectoryPageId(key, true));
+    WritePageGuard bucket_guard =
+        buffer_pool_manager_->FetchPageWrite(KeyToPageId(key, directory_guard.As<HashTableDirectoryPage>()));
+    directory_guard.Drop();
+    auto *bucket = bucket_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    if (!bucket->IsFull()) {
+      return bucket->Insert(key, value, Hash(key), comparator_);
+    }
+  }
+  return SplitInsert(transaction, key, value);
 }
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  WritePageGuard directory_guard = buffer_pool_manager_->FetchPageWrite(KeyToDirectoryPageId(key, false));
+  auto *dir_page = directory_guard.AsMut<HashTableDirectoryPage>();
+  // Other inserts may have split the bucket or filled the new one since, so split until the key's bucket has room.
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    WritePageGuard bucket_guard = buffer_pool_manager_->FetchPageWrite(dir_page->GetBucketPageId(bucket_idx));
+    auto *bucket = bucket_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    if (!bucket->IsFull()) {
+      return bucket->Insert(key, value, Hash(key), comparator_);
+    }
+    std::vector<ValueType> values;
+    bucket->GetValue(key, Hash(key), comparator_, &values);
+    if (std::find(values.begin(), values.end(), value) != values.end()) {
+      return false;
+    }
+
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == dir_page->GetGlobalDepth()) {
+      if (dir_page->Size() * 2 > DIRECTORY_ARRAY_SIZE) {
+        return false;
+      }
+      dir_page->IncrGlobalDepth();
+    }
+    page_id_t image_page_id;
+    BasicPageGuard image_guard = buffer_pool_manager_->NewPageGuarded(&image_page_id);
+    if (image_guard.GetDataMut() == nullptr) {
+      return false;
+    }
+    auto *image = image_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+
+    // Every slot that led to the bucket goes one level deeper; those with the new hash bit set lead to the image.
+    uint32_t high_bit = 1U << local_depth;
+    uint32_t low_bits = bucket_idx & (high_bit - 1);
+    for (uint32_t idx = low_bits; idx < dir_page->Size(); idx += high_bit) {
+      dir_page->IncrLocalDepth(idx);
+      if ((idx & high_bit) != 0) {
+        dir_page->SetBucketPageId(idx, image_page_id);
+      }
+    }
+    for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE && bucket->IsOccupied(slot); slot++) {
+      if (!bucket->IsReadable(slot)) {
+        continue;
+      }
+      uint32_t hash = Hash(bucket->KeyAt(slot));
+      if ((hash & high_bit) != 0) {
+        image->Insert(bucket->KeyAt(slot), bucket->ValueAt(slot), hash, comparator_);
+        bucket->RemoveAt(slot);
+      }
+    }
+  }
 }
 
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  page_id_t directory_page_id = KeyToDirectoryPageId(key, false);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  bool now_empty;
+  {
+    ReadPageGuard directory_guard = buffer_pool_manager_->FetchPageRead(directory_page_id);
+    WritePageGuard bucket_guard =
+        buffer_pool_manager_->FetchPageWrite(KeyToPageId(key, directory_guard.As<HashTableDirectoryPage>()));
+    directory_guard.Drop();
+    auto *bucket = bucket_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    if (!bucket->Remove(key, value, Hash(key), comparator_)) {
+      return false;
+    }
+    now_empty = bucket->IsEmpty();
+  }
+  if (now_empty) {
+    Merge(transaction, key, value);
+  }
+  return true;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  WritePageGuard directory_guard = buffer_pool_manager_->FetchPageWrite(KeyToDirectoryPageId(key, false));
+  auto *dir_page = directory_guard.AsMut<HashTableDirectoryPage>();
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (local_depth == 0 || dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    // Both buckets are only reachable through the directory, so no one else can be waiting to latch them.
+    WritePageGuard bucket_guard = buffer_pool_manager_->FetchPageWrite(dir_page->GetBucketPageId(bucket_idx));
+    WritePageGuard image_guard = buffer_pool_manager_->FetchPageWrite(dir_page->GetBucketPageId(image_idx));
+    bool bucket_empty = bucket_guard.As<HASH_TABLE_BUCKET_TYPE>()->IsEmpty();
+    if (!bucket_empty && !image_guard.As<HASH_TABLE_BUCKET_TYPE>()->IsEmpty()) {
+      break;
+    }
+    page_id_t kept_page_id = bucket_empty ? image_guard.PageId() : bucket_guard.PageId();
+    page_id_t dropped_page_id = bucket_empty ? bucket_guard.PageId() : image_guard.PageId();
+    bucket_guard.Drop();
+    image_guard.Drop();
+
+    uint32_t high_bit = 1U << (local_depth - 1);
+    for (uint32_t idx = bucket_idx & (high_bit - 1); idx < dir_page->Size(); idx += high_bit) {
+      dir_page->SetBucketPageId(idx, kept_page_id);
+      dir_page->DecrLocalDepth(idx);
+    }
+    buffer_pool_manager_->DeletePage(dropped_page_id);
+  }
+  while (dir_page->CanShrink()) {
+    dir_page->DecrGlobalDepth();
+  }
+}
 
 /*****************************************************************************
  * GETGLOBALDEPTH - DO NOT TOUCH
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  uint32_t global_depth = dir_page->GetGlobalDepth();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-  table_latch_.RUnlock();
+  ReadPageGuard header_guard = buffer_pool_manager_->FetchPageRead(header_page_id_);
+  auto *header_page = header_guard.As<HashTableDirectoryHeaderPage>();
+  uint32_t global_depth = 0;
+  for (uint32_t directory_idx = 0; directory_idx < header_page->MaxSize(); directory_idx++) {
+    page_id_t directory_page_id = header_page->GetDirectoryPageId(directory_idx);
+    if (directory_page_id != INVALID_PAGE_ID) {
+      ReadPageGuard directory_guard = buffer_pool_manager_->FetchPageRead(directory_page_id);
+      global_depth = std::max(global_depth, directory_guard.As<HashTableDirectoryPage>()->GetGlobalDepth());
+    }
+  }
   return global_depth;
 }
 
 /*****************************************************************************
  * VERIFY INTEGRITY - DO NOT TOUCH
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  dir_page->VerifyIntegrity();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-  table_latch_.RUnlock();
+  ReadPageGuard header_guard = buffer_pool_manager_->FetchPageRead(header_page_id_);
+  auto *header_page = header_guard.As<HashTableDirectoryHeaderPage>();
+  for (uint32_t directory_idx = 0; directory_idx < header_page->MaxSize(); directory_idx++) {
+    page_id_t directory_page_id = header_page->GetDirectoryPageId(directory_idx);
+    if (directory_page_id != INVALID_PAGE_ID) {
+      WritePageGuard directory_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id);
+      directory_guard.AsMut<HashTableDirectoryPage>()->VerifyIntegrity();
+    }
+  }
 }
 
 /*****************************************************************************
@@ -135,4 +292,10 @@ template class DiskExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16
 template class DiskExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
 template class DiskExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class DiskExtendibleHashTable<int, int, IntComparator, HashFunction<int, WyHasher>>;
+template class DiskExtendibleHashTable<int, int, IntComparator, HashFunction<int, Crc32cHasher>>;
+template class DiskExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>, HashFunction<GenericKey<8>, WyHasher>>;
+template class DiskExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>,
+                                       HashFunction<GenericKey<8>, Crc32cHasher>>;
+
 }  // namespace bustub
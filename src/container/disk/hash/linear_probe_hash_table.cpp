@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,47 +24,280 @@
 
 namespace bustub {
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                      const KeyComparator &comparator, size_t num_buckets,
-                                      HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+                                      const KeyComparator &comparator, size_t num_buckets, HashFn hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  header_page_id_ = CreateTable(std::max<size_t>(num_buckets, 1));
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  bool found = GetValueLatchFree(transaction, key, result);
+  table_latch_.RUnlock();
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+auto HASH_TABLE_TYPE::GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result)
+    -> bool {
+  bool found = false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = HASH_TABLE_BLOCK_TYPE::Fingerprint(hash);
+  for (page_id_t header_page_id : {old_header_page_id_, header_page_id_}) {
+    if (header_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    Probe(header_page_id, hash, [&](BasicPageGuard &block_guard, slot_offset_t slot) {
+      auto *block = block_guard.As<HASH_TABLE_BLOCK_TYPE>();
+      if (!block->IsOccupied(slot)) {
+        return true;
+      }
+      // The fingerprint rules out most other keys of the probe sequence without reading them.
+      if (block->FingerprintAt(slot) == fingerprint && block->IsReadable(slot) &&
+          comparator_(block->KeyAt(slot), key) == 0) {
+        result->push_back(block->ValueAt(slot));
+        found = true;
+      }
+      return false;
+    });
+  }
+  return found;
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  Migrate(LINEAR_PROBE_MIGRATE_SLOTS);
+  std::vector<ValueType> values;
+  GetValueLatchFree(transaction, key, &values);
+  if (std::find(values.begin(), values.end(), value) != values.end()) {
+    table_latch_.WUnlock();
+    return false;
+  }
+
+  size_t size;
+  {
+    BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id_);
+    size = header_guard.As<HashTableHeaderPage>()->GetSize();
+  }
+  if (old_header_page_id_ == INVALID_PAGE_ID && static_cast<double>(num_occupied_ + 1) > size * LINEAR_PROBE_MAX_LOAD) {
+    // Mostly tombstones are dropped by moving the entries to a table of the same size. That only pays off with more
+    // tombstones than the migration can take inserts, otherwise the next insert would start the same resize again.
+    // Once the table can neither grow nor shed tombstones, inserts fill it up and then fail.
+    size_t max_slots = HashTableHeaderPage::MaxNumBlocks() * BLOCK_ARRAY_SIZE;
+    size_t new_size = std::min(num_entries_ * 2 > num_occupied_ ? 2 * size : size, max_slots);
+    bool sheds_tombstones = num_occupied_ - num_entries_ > size / LINEAR_PROBE_MIGRATE_SLOTS;
+    if ((new_size > size || sheds_tombstones) && BeginResize(new_size)) {
+      Migrate(LINEAR_PROBE_MIGRATE_SLOTS);
+    }
+  }
+  bool inserted = ResizeInsert(header_page_id_, key, value);
+  if (inserted) {
+    num_entries_++;
+  }
+  table_latch_.WUnlock();
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+auto HASH_TABLE_TYPE::ResizeInsert(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool {
+  bool inserted = false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = HASH_TABLE_BLOCK_TYPE::Fingerprint(hash);
+  Probe(header_page_id, hash, [&](BasicPageGuard &block_guard, slot_offset_t slot) {
+    if (block_guard.As<HASH_TABLE_BLOCK_TYPE>()->IsOccupied(slot)) {
+      return false;
+    }
+    inserted = block_guard.AsMut<HASH_TABLE_BLOCK_TYPE>()->Insert(slot, key, value, fingerprint);
+    return true;
+  });
+  if (inserted) {
+    num_occupied_++;
+  }
+  return inserted;
 }
 
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  Migrate(LINEAR_PROBE_MIGRATE_SLOTS);
+  bool removed = false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = HASH_TABLE_BLOCK_TYPE::Fingerprint(hash);
+  for (page_id_t header_page_id : {old_header_page_id_, header_page_id_}) {
+    if (header_page_id == INVALID_PAGE_ID || removed) {
+      continue;
+    }
+    Probe(header_page_id, hash, [&](BasicPageGuard &block_guard, slot_offset_t slot) {
+      auto *block = block_guard.As<HASH_TABLE_BLOCK_TYPE>();
+      if (!block->IsOccupied(slot)) {
+        return true;
+      }
+      if (block->FingerprintAt(slot) == fingerprint && block->IsReadable(slot) &&
+          comparator_(block->KeyAt(slot), key) == 0 && block->ValueAt(slot) == value) {
+        block_guard.AsMut<HASH_TABLE_BLOCK_TYPE>()->Remove(slot);
+        removed = true;
+      }
+      return removed;
+    });
+  }
+  if (removed) {
+    num_entries_--;
+  }
+  table_latch_.WUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  Migrate(std::numeric_limits<size_t>::max());
+  BeginResize(std::max(2 * initial_size, num_entries_ + 1));
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+auto HASH_TABLE_TYPE::BeginResize(size_t num_slots) -> bool {
+  size_t old_size;
+  {
+    BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id_);
+    old_size = header_guard.As<HashTableHeaderPage>()->GetSize();
+  }
+  // Every write moves LINEAR_PROBE_MIGRATE_SLOTS slots, which bounds the inserts the new table takes on top of the
+  // entries moved over. Removes during the migration leave tombstones but never add occupied slots.
+  size_t needed_slots = num_entries_ + old_size / LINEAR_PROBE_MIGRATE_SLOTS + 1;
+  size_t max_slots = HashTableHeaderPage::MaxNumBlocks() * BLOCK_ARRAY_SIZE;
+  num_slots = std::min(std::max(num_slots, needed_slots), max_slots);
+  if (num_slots < needed_slots) {
+    return false;
+  }
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = CreateTable(num_slots);
+  next_migrate_slot_ = 0;
+  num_occupied_ = 0;
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::Migrate(size_t max_slots) {
+  if (old_header_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  {
+    BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(old_header_page_id_);
+    auto *header_page = header_guard.As<HashTableHeaderPage>();
+    size_t start_slot = next_migrate_slot_;
+    size_t end_slot = start_slot + std::min(max_slots, header_page->GetSize() - start_slot);
+    BasicPageGuard block_guard;
+    for (; next_migrate_slot_ < end_slot; next_migrate_slot_++) {
+      slot_offset_t slot = next_migrate_slot_ % BLOCK_ARRAY_SIZE;
+      if (next_migrate_slot_ == start_slot || slot == 0) {
+        block_guard =
+            buffer_pool_manager_->FetchPageBasic(header_page->GetBlockPageId(next_migrate_slot_ / BLOCK_ARRAY_SIZE));
+      }
+      auto *block = block_guard.As<HASH_TABLE_BLOCK_TYPE>();
+      if (block->IsReadable(slot)) {
+        // BeginResize sizes the new table so that this cannot fail; should it anyway, the entry stays where it is,
+        // still found by lookups, and the migration stops here.
+        if (!ResizeInsert(header_page_id_, block->KeyAt(slot), block->ValueAt(slot))) {
+          return;
+        }
+        // The slot becomes a tombstone, so the probe sequences of the entries not moved yet stay intact.
+        block_guard.AsMut<HASH_TABLE_BLOCK_TYPE>()->Remove(slot);
+      }
+    }
+    if (next_migrate_slot_ < header_page->GetSize()) {
+      return;
+    }
+  }
+  DeleteBlockPages(old_header_page_id_);
+  old_header_page_id_ = INVALID_PAGE_ID;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+auto HASH_TABLE_TYPE::CreateTable(size_t num_slots) -> page_id_t {
+  page_id_t header_page_id;
+  BasicPageGuard header_guard = buffer_pool_manager_->NewPageGuarded(&header_page_id);
+  BUSTUB_ENSURE(header_guard.GetDataMut() != nullptr, "no frame for the hash table header page");
+  auto *header_page = header_guard.AsMut<HashTableHeaderPage>();
+  header_page->SetPageId(header_page_id);
+  header_page->SetSize(num_slots);
+  CreateNewBlockPages(header_page, (num_slots - 1) / BLOCK_ARRAY_SIZE + 1);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks) {
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    BasicPageGuard block_guard = buffer_pool_manager_->NewPageGuarded(&block_page_id);
+    BUSTUB_ENSURE(block_guard.GetDataMut() != nullptr, "no frame for a hash table block page");
+    header_page->AddBlockPageId(block_page_id);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+void HASH_TABLE_TYPE::DeleteBlockPages(page_id_t old_header_page_id) {
+  {
+    BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(old_header_page_id);
+    auto *header_page = header_guard.As<HashTableHeaderPage>();
+    for (size_t i = 0; i < header_page->NumBlocks(); i++) {
+      buffer_pool_manager_->DeletePage(header_page->GetBlockPageId(i));
+    }
+  }
+  buffer_pool_manager_->DeletePage(old_header_page_id);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+template <typename Callback>
+void HASH_TABLE_TYPE::Probe(page_id_t header_page_id, uint64_t hash, Callback &&callback) {
+  BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id);
+  auto *header_page = header_guard.As<HashTableHeaderPage>();
+  size_t size = header_page->GetSize();
+  size_t index = hash % size;
+  BasicPageGuard block_guard;
+  for (size_t probes = 0; probes < size; probes++, index = index + 1 == size ? 0 : index + 1) {
+    if (probes == 0 || index % BLOCK_ARRAY_SIZE == 0) {
+      block_guard = buffer_pool_manager_->FetchPageBasic(header_page->GetBlockPageId(index / BLOCK_ARRAY_SIZE));
+    }
+    if (callback(block_guard, index % BLOCK_ARRAY_SIZE)) {
+      return;
+    }
+  }
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
 auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+  table_latch_.RLock();
+  BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id_);
+  size_t size = header_guard.As<HashTableHeaderPage>()->GetSize();
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn>
+auto HASH_TABLE_TYPE::IsResizing() -> bool {
+  table_latch_.RLock();
+  bool resizing = old_header_page_id_ != INVALID_PAGE_ID;
+  table_latch_.RUnlock();
+  return resizing;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -73,4 +308,10 @@ template class LinearProbeHashTable<GenericKey<16>, RID, GenericComparator<16>>;
 template class LinearProbeHashTable<GenericKey<32>, RID, GenericComparator<32>>;
 template class LinearProbeHashTable<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class LinearProbeHashTable<int, int, IntComparator, HashFunction<int, WyHasher>>;
+template class LinearProbeHashTable<int, int, IntComparator, HashFunction<int, Crc32cHasher>>;
+template class LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>, HashFunction<GenericKey<8>, WyHasher>>;
+template class LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>,
+                                    HashFunction<GenericKey<8>, Crc32cHasher>>;
+
 }  // namespace bustub
@@ -11,12 +11,81 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include "type/value_factory.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void IndexScanExecutor::Init() {
+  auto *catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info_->table_name_);
+  tree_ = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_info_->index_.get());
+  BUSTUB_ENSURE(tree_ != nullptr, "index scans need a B+ tree index");
+
+  // An exclusive lower bound has to skip all keys with that first column, so it is filled high; an exclusive upper
+  // bound has to stop before all of them, so it is filled low.
+  scan_ = {};
+  scan_.reverse_ = plan_->reverse_;
+  if (plan_->lower_bound_.has_value()) {
+    scan_.lower_ = tree_->MakeBoundKey({*plan_->lower_bound_}, !plan_->lower_inclusive_);
+    scan_.lower_inclusive_ = plan_->lower_inclusive_;
+  }
+  if (plan_->upper_bound_.has_value()) {
+    scan_.upper_ = tree_->MakeBoundKey({*plan_->upper_bound_}, plan_->upper_inclusive_);
+    scan_.upper_inclusive_ = plan_->upper_inclusive_;
+  }
+  entries_.clear();
+  next_entry_ = 0;
+}
 
-void IndexScanExecutor::Init() { throw NotImplementedException("IndexScanExecutor is not implemented"); }
+auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (next_entry_ == entries_.size()) {
+      entries_.clear();
+      next_entry_ = 0;
+      if (!tree_->ScanRange(&scan_, &entries_)) {
+        return false;
+      }
+    }
+    const auto &[key, candidate_rid] = entries_[next_entry_++];
+    Tuple candidate;
+    if (plan_->index_only_) {
+      // Deletes remove the index entries of a row and CreateIndex() skips deleted rows, so every entry found belongs
+      // to a live row.
+      candidate = TupleFromKey(key);
+    } else {
+      auto [meta, heap_tuple] = table_info_->table_->GetTuple(candidate_rid);
+      if (meta.is_deleted_) {
+        continue;
+      }
+      candidate = std::move(heap_tuple);
+    }
+    if (plan_->filter_predicate_ != nullptr) {
+      auto value = plan_->filter_predicate_->Evaluate(&candidate, table_info_->schema_);
+      if (value.IsNull() || !value.GetAs<bool>()) {
+        continue;
+      }
+    }
+    *tuple = std::move(candidate);
+    *rid = candidate_rid;
+    return true;
+  }
+}
 
-auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto IndexScanExecutor::TupleFromKey(const IntegerKeyType &key) const -> Tuple {
+  const Schema &schema = table_info_->schema_;
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  for (const auto &column : schema.GetColumns()) {
+    values.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+  }
+  const auto &key_attrs = index_info_->index_->GetKeyAttrs();
+  for (uint32_t i = 0; i < key_attrs.size(); i++) {
+    values[key_attrs[i]] = key.ToValue(tree_->GetKeySchema(), i);
+  }
+  return {values, &schema};
+}
 
 }  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * BufferAccessStrategy is the private ring of frames of one scan. Misses fetched or prefetched with a strategy are
+ * loaded into the frames of its ring, which are recycled round robin instead of evicting the pages of other users of
+ * the pool, see BufferPoolManager::FetchPage(). The ring of one buffer pool instance holds at most
+ * BufferPoolManager::GetScanRingSize() frames.
+ *
+ * A strategy belongs to one scan and must not be used by several threads at the same time. It must not outlive the
+ * buffer pool it is used with. Destroying it hands the frames of its ring back to the replacer.
+ */
+class BufferAccessStrategy {
+ public:
+  BufferAccessStrategy() = default;
+
+  DISALLOW_COPY_AND_MOVE(BufferAccessStrategy);
+
+  ~BufferAccessStrategy();
+
+ private:
+  friend class BufferPoolManager;
+
+  /** The frames of the strategy in one buffer pool instance. */
+  struct Ring {
+    /** The instance the frames belong to, nullptr until the strategy is first used with it. */
+    BufferPoolManager *bpm_{nullptr};
+    /** Frames in the order they are recycled. Empty slots hold -1. */
+    std::vector<frame_id_t> frames_;
+    /** Next slot of frames_ to recycle. */
+    size_t pos_{0};
+  };
+
+  /** rings_[i] is the ring in the buffer pool instance with index i. */
+  std::vector<Ring> rings_;
+};
+
+}  // namespace bustub
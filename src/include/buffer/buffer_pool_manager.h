@@ -12,14 +12,21 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/frame_arena.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/page_table.h"
 #include "common/config.h"
+#include "common/macros.h"
 #include "recovery/log_manager.h"
+#include "storage/disk/async_disk_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
 #include "storage/page/page_guard.h"
@@ -41,16 +48,33 @@ class BufferPoolManager {
   BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
                     LogManager *log_manager = nullptr);
 
+  /**
+   * @brief Creates a new BufferPoolManager that is one instance of a ParallelBufferPoolManager.
+   * @param pool_size the size of this instance
+   * @param num_instances the total number of instances in the parallel buffer pool
+   * @param instance_index the index of this instance in the parallel buffer pool
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   */
+  BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index, DiskManager *disk_manager,
+                    size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr);
+
+  DISALLOW_COPY_AND_MOVE(BufferPoolManager);
+
   /**
    * @brief Destroy an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager();
 
   /** @brief Return the size (number of frames) of the buffer pool. */
-  auto GetPoolSize() -> size_t { return pool_size_; }
+  virtual auto GetPoolSize() -> size_t { return pool_size_; }
+
+  /** @brief Return the number of frames the ring of a BufferAccessStrategy holds in this pool, see FetchPage(). */
+  virtual auto GetScanRingSize() -> size_t { return scan_ring_size_; }
 
   /** @brief Return the pointer to all the pages in the buffer pool. */
-  auto GetPages() -> Page * { return pages_; }
+  virtual auto GetPages() -> Page * { return pages_; }
 
   /**
    * TODO(P1): Add implementation
@@ -69,7 +93,7 @@ class BufferPoolManager {
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  auto NewPage(page_id_t *page_id) -> Page *;
+  virtual auto NewPage(page_id_t *page_id) -> Page *;
 
   /**
    * TODO(P1): Add implementation
@@ -98,11 +122,28 @@ class BufferPoolManager {
    *
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPage().
    *
+   * Misses fetched with a strategy do not compete for the whole pool: they are loaded into the strategy's private
+   * ring of at most GetScanRingSize() frames, which is recycled round robin, so a large sequential scan does not flush
+   * the hot pages of point lookups out of the pool. Only while the ring is still filling up, or when every frame of it
+   * is pinned, does a miss take a frame from the free list or the replacer. Pages in a ring are not evictable by the
+   * replacer; they are only reclaimed outside their ring when no other frame is left.
+   * A ring page that is later fetched by a non-scan access leaves the ring and is treated like any other page.
+   *
+   * A miss reads the page without holding the buffer pool latch. The page is in the page table during the read, and
+   * concurrent fetches of it wait for the read to finish. If the read, or the write back of the victim, throws, the
+   * exception is passed on and the pool is left as if the fetch had not happened.
+   *
+   * A hit is served without the buffer pool latch: the page table is probed latch-free and the frame is pinned with a
+   * compare-and-swap on its pin count, which fails while the frame is being replaced. Only misses (and hits that race
+   * with a replacement) take the latch.
+   *
    * @param page_id id of page to be fetched
    * @param access_type type of access to the page, only needed for leaderboard tests.
+   * @param strategy the ring a miss is loaded into, nullptr to load it like any other page
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
-  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
+  virtual auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown,
+                         BufferAccessStrategy *strategy = nullptr) -> Page *;
 
   /**
    * TODO(P1): Add implementation
@@ -115,11 +156,16 @@ class BufferPoolManager {
    * the returned page already has a read or write latch held, respectively.
    *
    * @param page_id, the id of the page to fetch
+   * @param access_type type of access to the page, see FetchPage()
+   * @param strategy the ring a miss is loaded into, see FetchPage()
    * @return PageGuard holding the fetched page
    */
-  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
-  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
-  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+  auto FetchPageBasic(page_id_t page_id, AccessType access_type = AccessType::Unknown,
+                      BufferAccessStrategy *strategy = nullptr) -> BasicPageGuard;
+  auto FetchPageRead(page_id_t page_id, AccessType access_type = AccessType::Unknown,
+                     BufferAccessStrategy *strategy = nullptr) -> ReadPageGuard;
+  auto FetchPageWrite(page_id_t page_id, AccessType access_type = AccessType::Unknown,
+                      BufferAccessStrategy *strategy = nullptr) -> WritePageGuard;
 
   /**
    * TODO(P1): Add implementation
@@ -130,12 +176,14 @@ class BufferPoolManager {
    * Decrement the pin count of a page. If the pin count reaches 0, the frame should be evictable by the replacer.
    * Also, set the dirty flag on the page to indicate if the page was modified.
    *
+   * Unpins that neither dirty the page nor drop its pin count to 0 do not take the buffer pool latch.
+   *
    * @param page_id id of page to be unpinned
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @param access_type type of access to the page, only needed for leaderboard tests.
    * @return false if the page is not in the page table or its pin count is <= 0 before this call, true otherwise
    */
-  auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
+  virtual auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
 
   /**
    * TODO(P1): Add implementation
@@ -148,20 +196,20 @@ class BufferPoolManager {
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  auto FlushPage(page_id_t page_id) -> bool;
+  virtual auto FlushPage(page_id_t page_id) -> bool;
 
   /**
    * TODO(P1): Add implementation
    *
    * @brief Flush all the pages in the buffer pool to disk.
    */
-  void FlushAllPages();
+  virtual void FlushAllPages();
 
   /**
    * TODO(P1): Add implementation
    *
-   * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, do nothing and return true. If the
-   * page is pinned and cannot be deleted, return false immediately.
+   * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, only deallocate it and return true.
+   * If the page is pinned and cannot be deleted, return false immediately.
    *
    * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
    * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
@@ -170,57 +218,177 @@ class BufferPoolManager {
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  auto DeletePage(page_id_t page_id) -> bool;
+  virtual auto DeletePage(page_id_t page_id) -> bool;
+
+  /**
+   * @brief Start reading page_id into the buffer pool in the background, as a hint that it will be fetched soon.
+   *
+   * The page is loaded like a miss with AccessType::Scan, i.e. into the ring of strategy if there is one, but the read
+   * is submitted to an AsyncDiskManager and PrefetchPage() returns right away. A FetchPage() of the page that comes in before the read
+   * completes waits for it instead of reading the page again. Once loaded, the page sits unpinned in the pool. Nothing
+   * happens if the page is already in the pool or no frame can be allocated for it.
+   *
+   * @param page_id id of page to be prefetched
+   * @param strategy the ring the page is loaded into, nullptr to load it like any other page
+   */
+  virtual void PrefetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * @brief Start a background thread that writes dirty pages back before they are chosen as victims.
+   *
+   * Once more than high_watermark of the pool is dirty, the flusher walks the cold end of the replacer and writes its
+   * dirty pages in batches of FLUSHER_BATCH_SIZE until at most low_watermark of the pool is dirty, so that evictions
+   * mostly find clean frames and NewPage()/FetchPage() rarely wait for a write. Frames of scan rings are never in the
+   * replacer and are recycled within a few misses, so the flusher writes every page of a ring that is unpinned dirty,
+   * whatever the dirty ratio. The writes of a batch are submitted to an
+   * AsyncDiskManager together, without the global latch; the pages of the batch stay pinned instead, so DeletePage() on
+   * one of them fails for that time.
+   *
+   * @param high_watermark dirty ratio (0, 1] at which the flusher starts writing
+   * @param low_watermark dirty ratio [0, high_watermark] at which the flusher stops writing
+   */
+  virtual void StartBackgroundFlusher(double high_watermark = FLUSHER_HIGH_WATERMARK,
+                                      double low_watermark = FLUSHER_LOW_WATERMARK);
+
+  /**
+   * @brief Stop the background flusher and wait for it to finish its current batch. No-op if it is not running.
+   */
+  virtual void StopBackgroundFlusher();
 
  private:
+  friend class BufferAccessStrategy;
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
 
-  /** Array of buffer pool pages. */
+  /** Page data of all frames. */
+  FrameArena frame_arena_;
+  /** Array of buffer pool pages, i.e. the metadata of every frame. pages_[i] holds frame i of frame_arena_. */
   Page *pages_;
   /** Pointer to the disk manager. */
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_;
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Page table for keeping track of buffer pool pages, readable without latch_. */
+  PageTable page_table_;
   /** Replacer to find unpinned pages for replacement. */
   std::unique_ptr<LRUKReplacer> replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** Number of frames the ring of a BufferAccessStrategy holds in this instance, see FetchPage(). */
+  const size_t scan_ring_size_;
+  /** scan_owner_[frame_id] is the strategy whose ring the frame is in, nullptr if it is in none. */
+  std::vector<std::atomic<const BufferAccessStrategy *>> scan_owner_;
+  /** Number of frames whose dirty flag is set. */
+  size_t num_dirty_{0};
+  /** dirty_epoch_[frame_id] is bumped every time the frame is unpinned dirty, so the flusher can tell whether a page
+   * was modified while it was being written. */
+  std::vector<uint64_t> dirty_epoch_;
+  /** Signalled whenever a page finished loading, see FetchPage(). */
+  std::condition_variable io_cv_;
+  /** Asynchronous I/O for the background flusher and prefetches, created when it is first needed. */
+  std::unique_ptr<AsyncDiskManager> async_disk_manager_;
+  /** The background flusher, see StartBackgroundFlusher(). */
+  std::thread flusher_thread_;
+  std::condition_variable flusher_cv_;
+  bool flusher_running_{false};
+  /** Set when the dirty ratio crosses the high watermark, cleared by the flusher when it starts a pass. */
+  bool flush_requested_{false};
+  /** Frames of scan rings that became dirty since the flusher last looked, see StartBackgroundFlusher(). */
+  std::vector<frame_id_t> dirty_ring_frames_;
+  size_t flusher_high_dirty_{0};
+  size_t flusher_low_dirty_{0};
+  /** This latch serializes all changes to page_table_, free_list_, the scan rings and the page id and dirty flag of
+   * every frame of this instance. Pin counts only ever move away from -1 under it, see ClaimFrame(). */
   std::mutex latch_;
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk, reusing a deallocated page if the disk manager has one. Each instance only gets
+   * page ids congruent to instance_index_ modulo num_instances_.
    * @return the id of the allocated page
    */
   auto AllocatePage() -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk, so that AllocatePage() can hand it out again.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
 
   // TODO(student): You may add additional private members and helper functions
 
   /**
    * @brief 返回可分配的frame id 如果帧集合中无可分配，则驱逐一个帧
+   *
+   * The victim is written back if it is dirty, removed from the page table and its memory and metadata are reset.
+   * When the free list and the replacer are both empty, an unpinned page of a scan ring is the victim.
+   * Caller should acquire the latch before calling this function.
    * @return 如果无可分配返回false
    */
-  auto AllocateFrameId(page_id_t page_id, frame_id_t &frame_id) -> bool;
+  auto AllocateFrameId(frame_id_t &frame_id) -> bool;
+
+  /**
+   * @brief Write the page held in frame_id back to disk and clear its dirty flag. Caller should acquire the latch
+   * before calling this function.
+   */
+  void FlushFrame(frame_id_t frame_id);
+
+  /**
+   * @brief Pick the frame a miss with strategy should be loaded into: the oldest unpinned frame of the strategy's
+   * ring, starting at the slot that is next in turn. While the ring has empty slots, or if every frame of it is
+   * pinned, a regular frame from AllocateFrameId() takes over the slot that is next in turn. Caller should acquire the
+   * latch before calling this function.
+   * @return false if no frame could be allocated
+   */
+  auto AllocateScanFrameId(BufferAccessStrategy *strategy, frame_id_t &frame_id) -> bool;
+
+  /**
+   * @brief Claim and reset the frame of a ring, so that it can be reused. Caller should acquire the latch.
+   * @return false if the frame is pinned or still being read in
+   */
+  auto RecycleRingFrame(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Take the frames of strategy's ring out of the ring, so that the replacer can evict them once they are
+   * unpinned. Called when the strategy is destroyed.
+   */
+  void ReleaseScanRing(BufferAccessStrategy *strategy);
+
+  /**
+   * @brief Pin page_id without taking the latch, if it is in the pool and its frame is not being replaced.
+   * @return the pinned page, or nullptr if the caller has to go through the latched path
+   */
+  auto TryPinUnlatched(page_id_t page_id, AccessType access_type) -> Page *;
+
+  /**
+   * @brief A frame is loading while it holds a page that is in the page table but cannot be pinned yet. Caller should
+   * acquire the latch.
+   */
+  auto IsLoading(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Take an unpinned frame away from latch-free pinning by moving its pin count from 0 to -1. The frame stays
+   * claimed until a new page is published in it with a pin count of 1. Caller should acquire the latch.
+   * @return false if the frame got pinned in the meantime
+   */
+  auto ClaimFrame(frame_id_t frame_id) -> bool;
 
   /**
-   * @brief 是否有可驱逐的页
-   * @param frame_id frame的id
-   * @return 如果都被固定，返回false，否则true
+   * @brief Decrement the pin count of frame_id and make it evictable once it drops to 0. Caller should acquire the
+   * latch.
+   * @return false if the frame was not pinned
    */
-  auto IsAllocateFromReplacer() -> bool;
+  auto UnpinFrame(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Write back and detach the page held in the claimed frame frame_id, and reset the frame. Caller should acquire the latch
+   * before calling this function. If the write back throws, the page stays in the frame, dirty and evictable again.
+   */
+  void ResetFrame(frame_id_t frame_id);
 
   /**
    * @brief 查看在freelist中有空闲帧
@@ -228,5 +396,36 @@ class BufferPoolManager {
    * @return
    */
   auto GetFrameIDFromFreeList(frame_id_t &frame_id) -> bool;
+
+  /** @brief Set the dirty flag of a frame, keeping num_dirty_ up to date. Caller should acquire the latch. */
+  void SetDirty(frame_id_t frame_id, bool is_dirty);
+
+  /** @brief Create async_disk_manager_ if it does not exist yet. Caller should acquire the latch. */
+  auto GetAsyncDiskManager() -> AsyncDiskManager *;
+
+  /**
+   * @brief Publish the page a PrefetchPage() read into frame_id, or give the frame back if the read failed. Called on
+   * an I/O thread.
+   */
+  void FinishPrefetch(frame_id_t frame_id, page_id_t page_id, bool success);
+
+  /**
+   * @brief Give back the frame a failed read of page_id was claimed for, as if the page had never been published.
+   * Caller should acquire the latch.
+   */
+  void AbandonRead(frame_id_t frame_id, page_id_t page_id);
+
+  /** @brief Main loop of the background flusher thread. */
+  void BackgroundFlush();
+
+  /**
+   * @brief Write the dirty pages among candidates to disk, at most FLUSHER_BATCH_SIZE at a time, until at most
+   * target_dirty frames of the pool are dirty. The latch is released while the pages are written.
+   * @param lock the held lock on latch_
+   * @param candidates frames in eviction order
+   * @param target_dirty number of dirty frames at which to stop
+   */
+  void FlushCandidates(std::unique_lock<std::mutex> &lock, const std::vector<frame_id_t> &candidates,
+                       size_t target_dirty);
 };
 }  // namespace bustub
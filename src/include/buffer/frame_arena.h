@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrameArena is the memory behind the frames of a buffer pool instance: one contiguous, BUSTUB_PAGE_SIZE aligned
+ * mapping instead of a separate heap allocation per page. Frames are therefore eligible for direct I/O, and large
+ * pools can be backed by huge pages to cut TLB misses.
+ *
+ * Pools of at least BUSTUB_HUGE_PAGE_SIZE first try explicit huge pages (MAP_HUGETLB), then fall back to a regular
+ * mapping with a transparent huge page hint (MADV_HUGEPAGE), and finally to an aligned heap allocation.
+ *
+ * In AddressSanitizer builds every frame is followed by a poisoned gap of one page, so that writing past the end of a
+ * page is still reported instead of silently corrupting the next frame.
+ */
+class FrameArena {
+ public:
+  /**
+   * @brief Allocate zeroed memory for num_frames frames.
+   * @param num_frames the number of frames
+   */
+  explicit FrameArena(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  ~FrameArena();
+
+  /** @return the BUSTUB_PAGE_SIZE bytes of frame frame_id */
+  auto FrameData(frame_id_t frame_id) const -> char * { return base_ + static_cast<size_t>(frame_id) * stride_; }
+
+  /** @return true if the arena is backed by explicit huge pages */
+  auto UsesHugeTlb() const -> bool { return kind_ == Kind::HUGE_TLB; }
+
+ private:
+  enum class Kind { EMPTY, HUGE_TLB, MMAP, HEAP };
+
+  /** Distance between two frames, larger than a page in AddressSanitizer builds. */
+  size_t stride_;
+  /** Bytes reserved for the arena. */
+  size_t size_{0};
+  char *base_{nullptr};
+  Kind kind_{Kind::EMPTY};
+};
+
+}  // namespace bustub
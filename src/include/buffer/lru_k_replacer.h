@@ -12,13 +12,9 @@
 
 #pragma once
 
-#include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
 #include <vector>
 
-#include <chrono>
 #include "common/config.h"
 #include "common/macros.h"
 
@@ -26,27 +22,21 @@ namespace bustub {
 
 enum class AccessType { Unknown = 0, Get, Scan };
 
-class LRUKNode {
- private:
-  /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
-
-  [[maybe_unused]] std::list<size_t> history_{};
-  [[maybe_unused]] size_t k_{0};
-  [[maybe_unused]] frame_id_t fid_{0};
-  [[maybe_unused]] bool is_evictable_{false};
-
- public:
-  void SetHistory(const std::list<size_t> &history);
-  void SetK(size_t k);
-  void SetFid(frame_id_t fid);
-  void SetIsEvictable(bool isEvictable);
-  void AddOneToK();
-
-  auto GetFid() const -> frame_id_t;
-  auto GetK() const -> size_t;
-  auto GetHistory() -> std::list<size_t> &;
-  auto IsEvictable() const -> bool;
+/**
+ * Per-frame bookkeeping of the LRU-K replacer. Nodes live in a vector indexed by frame id, the last k timestamps of a
+ * frame live in a fixed ring inside LRUKReplacer::history_, so recording an access never allocates.
+ */
+struct LRUKNode {
+  /** Number of accesses recorded so far, saturates at k. */
+  size_t k_{0};
+  /** Ring slot of the oldest of the last k timestamps. */
+  size_t head_{0};
+  /** Oldest of the last k timestamps: the first access while k_ < k, the k-th most recent access afterwards. */
+  size_t kth_timestamp_{0};
+  /** Position inside the heap the frame is queued in, only meaningful while the frame is evictable. */
+  size_t heap_pos_{0};
+  bool is_evictable_{false};
+  bool is_tracked_{false};
 };
 
 /**
@@ -107,12 +97,23 @@ class LRUKReplacer {
    * If frame id is invalid (ie. larger than replacer_size_), throw an exception. You can
    * also use BUSTUB_ASSERT to abort the process if frame id is invalid.
    *
+   * A scan access to a frame that is already tracked is not recorded, so that sequential scans do not promote
+   * pages into the k-distance order.
+   *
    * @param frame_id id of frame that received a new access.
-   * @param access_type type of access that was received. This parameter is only needed for
-   * leaderboard tests.
+   * @param access_type type of access that was received.
    */
   void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
 
+  /**
+   * @brief Record an access like RecordAccess(), unless another thread is inside the replacer. Latch-free buffer pool
+   * hits use this so that they never queue up on the replacer latch; a dropped access only makes the k-distance of a
+   * frame that is pinned anyway slightly less accurate.
+   *
+   * @return true if the access was recorded
+   */
+  auto TryRecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown) -> bool;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -160,23 +161,50 @@ class LRUKReplacer {
    */
   auto Size() -> size_t;
 
- private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] std::unordered_map<frame_id_t, LRUKNode> node_store_;
-  [[maybe_unused]] size_t current_timestamp_{0};
-  [[maybe_unused]] size_t curr_size_{0};  // 可以被分配的
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
-  [[maybe_unused]] std::mutex latch_;
-
-  // todo std:: mutex
-
   /**
+   * @brief Peek at the cold end of the replacer without evicting anything.
+   *
+   * Frames are returned in the order Evict() would pick them, as long as nothing changes in between. Used by the
+   * buffer pool's background flusher to clean the pages that are about to be evicted.
    *
-   * @return
+   * @param max_count the maximum number of frames to return
+   * @return up to max_count evictable frames, next victim first
+   */
+  auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t>;
+
+ private:
+  /**
+   * Evictable frames are kept in two binary min-heaps ordered by LRUKNode::kth_timestamp_. Frames with fewer than k
+   * accesses (+inf backward k-distance) go to cold_heap_, which degenerates to a FIFO on their first access; frames
+   * with k accesses go to hot_heap_, whose top has the largest backward k-distance. Both heaps are preallocated to
+   * the number of frames, and a frame knows its own position, so every operation is O(log n) without allocating.
    */
-  auto GetCurrentTimeStamp() -> size_t;
+  using FrameHeap = std::vector<frame_id_t>;
+
+  auto HeapOf(frame_id_t frame_id) -> FrameHeap &;
+  void HeapPush(FrameHeap &heap, frame_id_t frame_id);
+  void HeapErase(FrameHeap &heap, frame_id_t frame_id);
+  void HeapSiftUp(FrameHeap &heap, size_t pos);
+  void HeapSiftDown(FrameHeap &heap, size_t pos);
+  void HeapSet(FrameHeap &heap, size_t pos, frame_id_t frame_id);
+
+  /** RecordAccess() without taking the latch. */
+  void RecordAccessLocked(frame_id_t frame_id, AccessType access_type);
+
+  /** Throw if frame_id cannot belong to this replacer. */
+  void CheckFrameId(frame_id_t frame_id) const;
+
+  std::vector<LRUKNode> node_store_;
+  /** Ring buffers of the last k timestamps, k slots per frame. */
+  std::vector<size_t> history_;
+  FrameHeap cold_heap_;
+  FrameHeap hot_heap_;
+  /** Logical clock, every access gets a distinct timestamp. */
+  size_t current_timestamp_{0};
+  size_t curr_size_{0};  // 可以被分配的
+  size_t replacer_size_;
+  size_t k_;
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the page ids held by a buffer pool instance to their frames.
+ *
+ * It is a fixed-capacity linear probing table sized for the number of frames, so it never rehashes. Every slot is a
+ * single 64-bit word holding both the page id and the frame id, which lets Find() run without any latch: a reader
+ * either sees a whole entry or none. Insert() and Erase() must be serialized by the caller (the buffer pool latch).
+ * Erase() shifts later entries back instead of leaving tombstones, so a concurrent Find() may miss an entry that is
+ * being moved, but it never returns a frame that the page id was not mapped to.
+ */
+class PageTable {
+ public:
+  /**
+   * @brief Create an empty page table.
+   * @param num_frames the maximum number of entries the table has to hold
+   */
+  explicit PageTable(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  ~PageTable() = default;
+
+  /**
+   * @brief Look up a page without latching. May spuriously miss while a writer is erasing.
+   * @return the frame holding page_id, or -1 if none was found
+   */
+  auto Find(page_id_t page_id) const -> frame_id_t;
+
+  /**
+   * @brief Map page_id to frame_id. page_id must not be in the table. Caller must serialize writers.
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Remove the mapping of page_id, if any. Caller must serialize writers.
+   */
+  void Erase(page_id_t page_id);
+
+  /** @return the number of entries in the table */
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  static constexpr uint64_t EMPTY_SLOT = ~static_cast<uint64_t>(0);
+
+  static auto MakeEntry(page_id_t page_id, frame_id_t frame_id) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static auto PageIdOf(uint64_t entry) -> page_id_t { return static_cast<page_id_t>(entry >> 32); }
+  static auto FrameIdOf(uint64_t entry) -> frame_id_t { return static_cast<frame_id_t>(entry & 0xFFFFFFFF); }
+
+  /** @return the slot a page id hashes to */
+  auto HomeSlot(page_id_t page_id) const -> size_t;
+
+  /** Power-of-two number of slots, at least twice the number of frames. */
+  size_t capacity_;
+  size_t mask_;
+  /** Right shift that maps the 64-bit multiplicative hash to a slot. */
+  int shift_;
+  size_t size_{0};
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool into several independent BufferPoolManager instances, each with
+ * its own free list, replacer, page table and latch. Page ids are striped across the instances, so a page always
+ * lives in instance `page_id % num_instances`.
+ *
+ * It exposes the same interface as BufferPoolManager, so it can be handed to TableHeap, BPlusTree and the page guards
+ * in place of a single instance. The BufferPoolManager it derives from is an empty pool with no frames that is never
+ * used: every virtual member is routed to the instances, and the non-virtual ones (the page guard helpers) only call
+ * virtual members. A member added to BufferPoolManager must keep to that or be overridden here, otherwise it runs
+ * against the empty pool.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @brief Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManager instances to create
+   * @param pool_size the pool size of each instance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of each instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr);
+
+  /**
+   * @brief Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @brief Return the total size of all the instances. */
+  auto GetPoolSize() -> size_t override;
+
+  /** @brief Return the number of frames the ring of a BufferAccessStrategy holds in each instance. */
+  auto GetScanRingSize() -> size_t override;
+
+  /**
+   * @brief The frames are split over the instances, so there is no single array of pages to return.
+   * @throws std::logic_error always, use GetBufferPoolManager(page_id)->GetPages() instead
+   */
+  auto GetPages() -> Page * override;
+
+  /**
+   * @brief Create a new page. Instances are tried in round robin order starting from a rotating index, so that
+   * allocations are spread evenly over the instances.
+   * @param[out] page_id id of created page
+   * @return nullptr if no instance could create a new page, otherwise pointer to new page
+   */
+  auto NewPage(page_id_t *page_id) -> Page * override;
+
+  /**
+   * @brief Fetch the requested page from the instance responsible for page_id.
+   */
+  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown,
+                 BufferAccessStrategy *strategy = nullptr) -> Page * override;
+
+  /**
+   * @brief Unpin the target page in the instance responsible for page_id.
+   */
+  auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool override;
+
+  /**
+   * @brief Flush the target page in the instance responsible for page_id.
+   */
+  auto FlushPage(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Flush all the pages of every instance to disk.
+   */
+  void FlushAllPages() override;
+
+  /**
+   * @brief Delete the target page in the instance responsible for page_id.
+   */
+  auto DeletePage(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Prefetch the target page in the instance responsible for page_id.
+   */
+  void PrefetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) override;
+
+  /**
+   * @brief Start a background flusher in every instance, the watermarks apply to each instance separately.
+   */
+  void StartBackgroundFlusher(double high_watermark = FLUSHER_HIGH_WATERMARK,
+                              double low_watermark = FLUSHER_LOW_WATERMARK) override;
+
+  /**
+   * @brief Stop the background flusher of every instance.
+   */
+  void StopBackgroundFlusher() override;
+
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManager instance responsible for handling given page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManager *;
+
+ private:
+  /** The individual instances, instance i owns the page ids congruent to i modulo num_instances. */
+  std::vector<std::unique_ptr<BufferPoolManager>> instances_;
+  /** Instance at which the next NewPage starts its round robin search. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
@@ -196,12 +196,16 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
-   * @return A (non-owning) pointer to the metadata of the new table
+   * @param is_unique Whether every key maps to at most one row
+   * @param included_column_count How many of the trailing key_attrs are included columns rather than search keys
+   * @return A (non-owning) pointer to the metadata of the new index, or NULL_INDEX_INFO if the table is missing, the
+   * index exists already or a unique index would repeat a key of the table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, bool is_unique = true,
+                   uint32_t included_column_count = 0) -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -218,7 +222,8 @@ class Catalog {
     }
 
     // Construct index metdata
-    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto meta =
+        std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, is_unique, included_column_count);
 
     // Construct the index, take ownership of metadata
     // TODO(Kyle): We should update the API for CreateIndex
@@ -228,11 +233,22 @@ class Catalog {
     // TODO(chi): support both hash index and btree index
     auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all live tuples in table heap, so that, as after deletes, every entry names a live row.
+    // The keys are collected and loaded bottom-up in one go, which saves a root-to-leaf descent per tuple and leaves
+    // the nodes evenly filled.
     auto *table_meta = GetTable(table_name);
+    std::vector<std::pair<KeyType, ValueType>> entries;
     for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
-      auto [meta, tuple] = iter.GetTuple();
-      index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
+      auto [tuple_meta, tuple] = iter.GetTuple();
+      if (tuple_meta.is_deleted_) {
+        continue;
+      }
+      entries.emplace_back(index->MakeKey(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid()),
+                           tuple.GetRid());
+    }
+    // A unique index cannot be built over rows that already repeat a key.
+    if (!index->BulkLoad(std::move(entries), txn)) {
+      return NULL_INDEX_INFO;
     }
 
     // Get the next OID for the new index
@@ -298,7 +314,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
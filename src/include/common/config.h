@@ -32,10 +32,23 @@ static constexpr int INVALID_TXN_ID = -1;
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
 static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int BUSTUB_HUGE_PAGE_SIZE = 2 * 1024 * 1024;                         // size of a huge page in byte
+static constexpr int BUSTUB_CACHE_LINE_SIZE = 64;                                    // size of a cache line in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int SCAN_RING_SIZE = 16;   // max frames a scan recycles in one buffer pool instance
+static constexpr double FLUSHER_HIGH_WATERMARK = 0.5;  // dirty ratio of the pool that wakes up the background flusher
+static constexpr double FLUSHER_LOW_WATERMARK = 0.25;  // dirty ratio the background flusher brings the pool down to
+static constexpr int FLUSHER_BATCH_SIZE = 16;          // pages the background flusher writes per latch release
+static constexpr int DISK_IO_THREADS = 4;              // I/O threads of an AsyncDiskManager
+static constexpr int READ_AHEAD_PAGES = 8;             // pages a sequential table scan prefetches ahead of itself
+static constexpr double BULK_LOAD_FILL_FACTOR = 0.9;   // fraction of each B+ tree node that BPlusTree::BulkLoad() fills
+static constexpr double LAZY_MERGE_THRESHOLD = 0.25;   // fill ratio below which lazily merged B+ tree leaves compact
+static constexpr int HASH_TABLE_HEADER_DEPTH = 9;      // high hash bits that pick an extendible hash directory
+static constexpr int LINEAR_PROBE_MIGRATE_SLOTS = 8;   // slots each LinearProbeHashTable write moves during a resize
+static constexpr double LINEAR_PROBE_MAX_LOAD = 0.75;  // occupied slot ratio at which a LinearProbeHashTable resizes
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
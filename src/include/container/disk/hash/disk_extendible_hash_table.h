@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <queue>
 #include <string>
 #include <vector>
 
@@ -20,18 +19,32 @@
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
 #include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_header_page.h"
 #include "storage/page/hash_table_directory_page.h"
 
 namespace bustub {
 
-#define HASH_TABLE_TYPE DiskExtendibleHashTable<KeyType, ValueType, KeyComparator>
+#define HASH_TABLE_TYPE DiskExtendibleHashTable<KeyType, ValueType, KeyComparator, HashFn>
 
 /**
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * A header page spreads the keys over up to 2^header_depth directories by the
+ * high bits of their hash. Each directory doubles and shrinks on its own, and
+ * is only created once a key hashes to it. Directories are never freed.
+ *
+ * There is no table-wide latch. Lookups, inserts and removes read-latch the
+ * header only to find their directory, and the directory page only until
+ * they hold the latch of their bucket page, so operations on different
+ * buckets run in parallel. Splits and merges write-latch one directory, then
+ * the buckets they change.
+ *
+ * HashFn picks the hash algorithm at compile time, e.g.
+ * HashFunction<KeyType, WyHasher>; see container/hash/hash_algorithms.h.
  */
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn = HashFunction<KeyType>>
 class DiskExtendibleHashTable {
  public:
   /**
@@ -40,9 +53,11 @@ class DiskExtendibleHashTable {
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
    * @param hash_fn the hash function
+   * @param header_depth the number of high hash bits that pick a directory
    */
   explicit DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+                                   const KeyComparator &comparator, HashFn hash_fn,
+                                   uint32_t header_depth = HASH_TABLE_HEADER_DEPTH);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -75,12 +90,12 @@ class DiskExtendibleHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Returns the global depth
+   * Returns the global depth of the deepest directory
    */
   auto GetGlobalDepth() -> uint32_t;
 
   /**
-   * Helper function to verify the integrity of the extendible hash table's directory.
+   * Helper function to verify the integrity of the extendible hash table's directories.
    */
   void VerifyIntegrity();
 
@@ -110,7 +125,7 @@ class DiskExtendibleHashTable {
    * @param dir_page to use for lookup of global depth
    * @return the directory index
    */
-  auto KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t;
+  auto KeyToDirectoryIndex(KeyType key, const HashTableDirectoryPage *dir_page) -> uint32_t;
 
   /**
    * Get the bucket page_id corresponding to a key.
@@ -119,36 +134,34 @@ class DiskExtendibleHashTable {
    * @param dir_page a pointer to the hash table's directory page
    * @return the bucket page_id corresponding to the input key
    */
-  auto KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t;
+  auto KeyToPageId(KeyType key, const HashTableDirectoryPage *dir_page) -> page_id_t;
 
   /**
-   * Fetches the directory page from the buffer pool manager.
+   * Finds the page of the directory a key belongs in.
    *
-   * @return a pointer to the directory page
-   */
-  auto FetchDirectoryPage() -> HashTableDirectoryPage *;
-
-  /**
-   * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
-   *
-   * @param bucket_page_id the page_id to fetch
-   * @return a pointer to a bucket page
+   * @param key the key for lookup
+   * @param create whether to create the directory if it does not exist yet
+   * @return the directory's page_id, INVALID_PAGE_ID if it does not exist and create is false
    */
-  auto FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE *;
+  auto KeyToDirectoryPageId(const KeyType &key, bool create) -> page_id_t;
 
   /**
-   * Performs insertion with an optional bucket splitting.
+   * Performs insertion with an optional bucket splitting. Called by Insert,
+   * without any latches held, if the key's bucket was full.
    *
    * @param transaction a pointer to the current transaction
    * @param key the key to insert
    * @param value the value to insert
-   * @return whether or not the insertion was successful
+   * @return whether or not the insertion was successful, false as well if the
+   * directory cannot grow any further
    */
   auto SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
 
   /**
    * Optionally merges an empty bucket into it's pair.  This is called by Remove,
-   * if Remove makes a bucket empty.
+   * without any latches held, if Remove makes a bucket empty. Merges cascade
+   * while the merged bucket can merge again, then the directory shrinks as far
+   * as it can.
    *
    * There are three conditions under which we skip the merge:
    * 1. The bucket is no longer empty.
@@ -162,13 +175,10 @@ class DiskExtendibleHashTable {
   void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
 
   // member variables
-  page_id_t directory_page_id_;
+  page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
-
-  // Readers includes inserts and removes, writers are splits and merges
-  ReaderWriterLatch table_latch_;
-  HashFunction<KeyType> hash_fn_;
+  HashFn hash_fn_;
 };
 
 }  // namespace bustub
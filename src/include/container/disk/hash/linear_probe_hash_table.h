@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <queue>
 #include <string>
 #include <vector>
 
@@ -24,14 +23,23 @@
 
 namespace bustub {
 
-#define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
+#define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator, HashFn>
 
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Resizing is incremental: the old and the new block pages coexist while each
+ * insert and remove moves the next LINEAR_PROBE_MIGRATE_SLOTS slots of the old
+ * table over, so no single write pays for rehashing the whole table. Lookups
+ * consult both tables until the migration is done. Removed slots stay occupied
+ * as tombstones until a resize drops them.
+ *
+ * HashFn picks the hash algorithm at compile time, as for
+ * DiskExtendibleHashTable.
  */
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn = HashFunction<KeyType>>
 class LinearProbeHashTable {
  public:
   /**
@@ -43,7 +51,7 @@ class LinearProbeHashTable {
    * @param hash_fn the hash function
    */
   explicit LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+                                const KeyComparator &comparator, size_t num_buckets, HashFn hash_fn);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -73,22 +81,40 @@ class LinearProbeHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Resizes the table to at least twice the initial size provided. The entries
+   * move over incrementally, a previous resize is finished first.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
 
   /**
    * Gets the size of the hash table
-   * @return current size of the hash table
+   * @return current size of the hash table, the new one during a resize
    */
   auto GetSize() -> size_t;
 
+  /**
+   * @return whether the entries of a previous table are still being moved over
+   */
+  auto IsResizing() -> bool;
+
  private:
-  auto GetHeaderPage() -> HashTableHeaderPage *;
-  auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
-  void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
-  void DeleteBlockPages(HashTableHeaderPage *old_header_page);
+  /** Calls callback(block_guard, slot) on the slots of the probe sequence of a key hash, until it returns true. */
+  template <typename Callback>
+  void Probe(page_id_t header_page_id, uint64_t hash, Callback &&callback);
+  /** Puts the pair into the first free slot of key's probe sequence. @return false if the table is full */
+  auto ResizeInsert(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool;
+  /**
+   * Starts an incremental resize to a new table of at least num_slots slots, enough for every entry and for the
+   * inserts that can arrive before the migration ends.
+   * @return false if no such table fits in a header page
+   */
+  auto BeginResize(size_t num_slots) -> bool;
+  /** Moves up to max_slots slots of the old table to the new one, and drops the old one once it is done. */
+  void Migrate(size_t max_slots);
+  /** @return the header page_id of a new table of num_slots empty slots */
+  auto CreateTable(size_t num_slots) -> page_id_t;
+  void DeleteBlockPages(page_id_t old_header_page_id);
   void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
   auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
@@ -97,11 +123,20 @@ class LinearProbeHashTable {
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // The table that is being moved into header_page_id_'s, INVALID_PAGE_ID if no resize is going on
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  // The next slot of the old table to move
+  size_t next_migrate_slot_{0};
+  // Entries in both tables
+  size_t num_entries_{0};
+  // Slots of the current table that hold an entry or a tombstone
+  size_t num_occupied_{0};
+
+  // Readers are lookups, writers are inserts and removes, which also move the entries during a resize
   ReaderWriterLatch table_latch_;
 
   // Hash function
-  HashFunction<KeyType> hash_fn_;
+  HashFn hash_fn_;
 };
 
 }  // namespace bustub
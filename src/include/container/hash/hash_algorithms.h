@@ -0,0 +1,217 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_algorithms.h
+//
+// Identification: src/include/container/hash/hash_algorithms.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+#include "murmur3/MurmurHash3.h"
+
+namespace bustub {
+
+// The hash algorithms a HashFunction can be built on. Each one hashes a byte string with Hash(), and a 4 or 8 byte key
+// loaded into an integer with HashInteger(), which skips the length dispatch. For MurmurHash3Hasher and Crc32cHasher
+// both give the same hash for the same bytes; WyHasher hashes integers with the shorter wyhash64.
+
+/** MurmurHash3 x64_128, truncated to 64 bits. The default, so that existing tables keep their layout. */
+struct MurmurHash3Hasher {
+  static auto Hash(const void *data, size_t len) -> uint64_t {
+    uint64_t hash[2];
+    murmur3::MurmurHash3_x64_128(data, static_cast<int>(len), 0, reinterpret_cast<void *>(&hash));
+    return hash[0];
+  }
+
+  static auto HashInteger(uint32_t value) -> uint64_t { return Hash(&value, sizeof(value)); }
+  static auto HashInteger(uint64_t value) -> uint64_t { return Hash(&value, sizeof(value)); }
+};
+
+/** wyhash (final version 4), a multiply-mix hash that reads 16 bytes at a time. */
+struct WyHasher {
+  static constexpr uint64_t SECRET[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL,
+                                         0x4d5a2da51de1aa47ULL};
+
+  static auto Hash(const void *data, size_t len) -> uint64_t {
+    const auto *p = static_cast<const uint8_t *>(data);
+    uint64_t seed = Mix(SECRET[0], SECRET[1]);
+    uint64_t a;
+    uint64_t b;
+    if (len <= 16) {
+      if (len >= 4) {
+        a = (Read4(p) << 32) | Read4(p + ((len >> 3) << 2));
+        b = (Read4(p + len - 4) << 32) | Read4(p + len - 4 - ((len >> 3) << 2));
+      } else if (len > 0) {
+        a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+        b = 0;
+      } else {
+        a = b = 0;
+      }
+    } else {
+      size_t i = len;
+      if (i > 48) {
+        uint64_t see1 = seed;
+        uint64_t see2 = seed;
+        do {
+          seed = Mix(Read8(p) ^ SECRET[1], Read8(p + 8) ^ seed);
+          see1 = Mix(Read8(p + 16) ^ SECRET[2], Read8(p + 24) ^ see1);
+          see2 = Mix(Read8(p + 32) ^ SECRET[3], Read8(p + 40) ^ see2);
+          p += 48;
+          i -= 48;
+        } while (i > 48);
+        seed ^= see1 ^ see2;
+      }
+      while (i > 16) {
+        seed = Mix(Read8(p) ^ SECRET[1], Read8(p + 8) ^ seed);
+        i -= 16;
+        p += 16;
+      }
+      a = Read8(p + i - 16);
+      b = Read8(p + i - 8);
+    }
+    a ^= SECRET[1];
+    b ^= seed;
+    Multiply(&a, &b);
+    return Mix(a ^ SECRET[0] ^ len, b ^ SECRET[1]);
+  }
+
+  /** wyhash64: a single 64x64->128 bit multiply, folded. */
+  static auto HashInteger(uint64_t value) -> uint64_t {
+    uint64_t a = value ^ SECRET[0];
+    uint64_t b = SECRET[1];
+    Multiply(&a, &b);
+    return Mix(a ^ SECRET[0], b ^ SECRET[1]);
+  }
+  static auto HashInteger(uint32_t value) -> uint64_t { return HashInteger(static_cast<uint64_t>(value)); }
+
+ private:
+  static void Multiply(uint64_t *a, uint64_t *b) {
+    __uint128_t product = static_cast<__uint128_t>(*a) * *b;
+    *a = static_cast<uint64_t>(product);
+    *b = static_cast<uint64_t>(product >> 64);
+  }
+  static auto Mix(uint64_t a, uint64_t b) -> uint64_t {
+    Multiply(&a, &b);
+    return a ^ b;
+  }
+  static auto Read8(const uint8_t *p) -> uint64_t {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  static auto Read4(const uint8_t *p) -> uint64_t {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+};
+
+/** @return the CRC32C of each byte value, for processing a byte at a time with the reflected polynomial */
+constexpr auto MakeCrc32cTable() -> std::array<uint32_t, 256> {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t byte = 0; byte < 256; byte++) {
+    uint32_t crc = byte;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ ((crc & 1) != 0 ? 0x82F63B78 : 0);
+    }
+    table[byte] = crc;
+  }
+  return table;
+}
+
+/**
+ * CRC32C (Castagnoli), using the SSE4.2 crc32 instruction when the CPU has it and a table otherwise. The 32 bit CRC is
+ * multiplied by an odd 64 bit constant. The low 32 bits of the product, which the extendible hash table uses for its
+ * directory index, header index and bucket fingerprints, are a bijection of the CRC; the high byte, which the linear
+ * probe blocks take their fingerprints from, depends on all of its bits.
+ */
+struct Crc32cHasher {
+  static auto Hash(const void *data, size_t len) -> uint64_t { return Spread(Crc32c(data, len)); }
+
+  static auto HashInteger(uint64_t value) -> uint64_t {
+#if defined(__x86_64__)
+    if (HasSse42()) {
+      return Spread(HardwareCrc64(value));
+    }
+#endif
+    return Hash(&value, sizeof(value));
+  }
+  static auto HashInteger(uint32_t value) -> uint64_t {
+#if defined(__x86_64__)
+    if (HasSse42()) {
+      return Spread(HardwareCrc32(value));
+    }
+#endif
+    return Hash(&value, sizeof(value));
+  }
+
+  /** @return the standard CRC32C of a byte string */
+  static auto Crc32c(const void *data, size_t len) -> uint32_t {
+#if defined(__x86_64__)
+    if (HasSse42()) {
+      return HardwareCrc(data, len);
+    }
+#endif
+    return SoftwareCrc(data, len);
+  }
+
+  /** @return the CRC32C of a byte string, computed with the lookup table; for testing the hardware path against */
+  static auto SoftwareCrc(const void *data, size_t len) -> uint32_t {
+    const auto *p = static_cast<const uint8_t *>(data);
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+      crc = TABLE[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+  }
+
+ private:
+  static constexpr std::array<uint32_t, 256> TABLE = MakeCrc32cTable();
+
+  static auto Spread(uint32_t crc) -> uint64_t { return crc * 0x9E3779B97F4A7C15ULL; }
+
+#if defined(__x86_64__)
+  // The build does not enable SSE4.2, so the crc32 instruction is compiled in for these functions only, and they are
+  // only called once the CPU is known to have it.
+  static auto HasSse42() -> bool {
+    static const bool has_sse42 = (__builtin_cpu_init(), __builtin_cpu_supports("sse4.2"));
+    return has_sse42;
+  }
+
+  __attribute__((target("sse4.2"))) static auto HardwareCrc(const void *data, size_t len) -> uint32_t {
+    const auto *p = static_cast<const uint8_t *>(data);
+    uint64_t crc = 0xFFFFFFFF;
+    for (; len >= 8; len -= 8, p += 8) {
+      uint64_t v;
+      memcpy(&v, p, sizeof(v));
+      crc = _mm_crc32_u64(crc, v);
+    }
+    for (; len > 0; len--, p++) {
+      crc = _mm_crc32_u8(static_cast<uint32_t>(crc), *p);
+    }
+    return ~static_cast<uint32_t>(crc);
+  }
+  __attribute__((target("sse4.2"))) static auto HardwareCrc64(uint64_t value) -> uint32_t {
+    return ~static_cast<uint32_t>(_mm_crc32_u64(0xFFFFFFFF, value));
+  }
+  __attribute__((target("sse4.2"))) static auto HardwareCrc32(uint32_t value) -> uint32_t {
+    return ~_mm_crc32_u32(0xFFFFFFFF, value);
+  }
+#endif
+};
+
+}  // namespace bustub
@@ -13,12 +13,17 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 
-#include "murmur3/MurmurHash3.h"
+#include "container/hash/hash_algorithms.h"
 
 namespace bustub {
 
-template <typename KeyType>
+/**
+ * Hashes keys with one of the algorithms of hash_algorithms.h, picked at compile time. Keys of 4 or 8 bytes, such as
+ * int and GenericKey<4> / GenericKey<8>, are loaded into an integer and take the algorithm's integer path.
+ */
+template <typename KeyType, typename Hasher = MurmurHash3Hasher>
 class HashFunction {
  public:
   /**
@@ -26,10 +31,17 @@ class HashFunction {
    * @return the hashed value
    */
   virtual auto GetHash(KeyType key) -> uint64_t {
-    uint64_t hash[2];
-    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
-                                 reinterpret_cast<void *>(&hash));
-    return hash[0];
+    if constexpr (sizeof(KeyType) == sizeof(uint32_t)) {
+      uint32_t value;
+      memcpy(&value, &key, sizeof(value));
+      return Hasher::HashInteger(value);
+    } else if constexpr (sizeof(KeyType) == sizeof(uint64_t)) {
+      uint64_t value;
+      memcpy(&value, &key, sizeof(value));
+      return Hasher::HashInteger(value);
+    } else {
+      return Hasher::Hash(reinterpret_cast<const void *>(&key), sizeof(KeyType));
+    }
   }
 };
 
@@ -12,12 +12,14 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/index_scan_plan.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -42,7 +44,19 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Builds the table tuple of an index-only scan from an index key: key and included columns, NULL elsewhere. */
+  auto TupleFromKey(const IntegerKeyType &key) const -> Tuple;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+
+  const IndexInfo *index_info_{nullptr};
+  const TableInfo *table_info_{nullptr};
+  BPlusTreeIndexForTwoIntegerColumn *tree_{nullptr};
+
+  /** The range scan, fetched from the index one leaf at a time. */
+  KeyRangeScan<IntegerKeyType> scan_;
+  std::vector<std::pair<IntegerKeyType, RID>> entries_;
+  size_t next_entry_{0};
 };
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -28,10 +29,13 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /**
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
-   * @param table_oid the identifier of table to be scanned
+   * @param index_oid the identifier of the index to be scanned
+   * @param filter_predicate the predicate the scanned tuples have to satisfy, nullptr for all of them
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, AbstractExpressionRef filter_predicate = nullptr)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        filter_predicate_(std::move(filter_predicate)) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
@@ -43,11 +47,44 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The predicate the scanned tuples have to satisfy, including the part the bounds below already take care of. */
+  AbstractExpressionRef filter_predicate_;
+
+  /** Bounds on the first column of the index key. A missing bound leaves that end of the scan open. */
+  std::optional<Value> lower_bound_;
+  bool lower_inclusive_{true};
+  std::optional<Value> upper_bound_;
+  bool upper_inclusive_{true};
+
+  /** Whether the keys are scanned in descending order. */
+  bool reverse_{false};
+
+  /**
+   * Whether the scan reads only the index. Its tuples then hold the key and included columns of the index and NULL
+   * in all other columns, which neither the filter predicate nor the parent plans may use.
+   */
+  bool index_only_{false};
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    std::string range;
+    if (lower_bound_.has_value() || upper_bound_.has_value()) {
+      // An open end excludes its infinity whatever its inclusive flag says.
+      range = fmt::format(", range={}{}, {}{}", lower_bound_.has_value() && lower_inclusive_ ? "[" : "(",
+                          lower_bound_.has_value() ? lower_bound_->ToString() : "-inf",
+                          upper_bound_.has_value() ? upper_bound_->ToString() : "+inf",
+                          upper_bound_.has_value() && upper_inclusive_ ? "]" : ")");
+    }
+    if (reverse_) {
+      range += ", reverse";
+    }
+    if (index_only_) {
+      range += ", index_only";
+    }
+    if (filter_predicate_) {
+      return fmt::format("IndexScan {{ index_oid={}{}, filter={} }}", index_oid_, range, filter_predicate_);
+    }
+    return fmt::format("IndexScan {{ index_oid={}{} }}", index_oid_, range);
   }
 };
 
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager.h
+//
+// Identification: src/include/storage/disk/async_disk_manager.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * @brief A single page read or write handed to the AsyncDiskManager.
+ */
+struct DiskRequest {
+  /** True for a write, false for a read. */
+  bool is_write_;
+  /**
+   * For a read, the buffer the page is read into. For a write, the page data to write. The buffer must stay valid and,
+   * for a write, unchanged until the request completes.
+   */
+  char *data_;
+  /** The page to read or write. */
+  page_id_t page_id_;
+  /** Fulfilled when the request completes: true on success, or the exception the disk manager threw. */
+  std::promise<bool> callback_;
+  /**
+   * Optional, run on the I/O thread right before callback_ is fulfilled, with whether the request succeeded. Lets a
+   * submitter that never waits for the future act on the completion.
+   */
+  std::function<void(bool)> on_complete_;
+};
+
+/**
+ * AsyncDiskManager gives submit/complete semantics on top of a DiskManager: Submit() queues a request and returns
+ * immediately, and the caller waits for the future of the request's promise whenever it needs the result. A pool of
+ * I/O threads serves the queue, so many requests can be in flight at the same time. How much of that turns into
+ * parallel disk I/O depends on the DiskManager underneath.
+ */
+class AsyncDiskManager {
+ public:
+  /**
+   * @brief Start the I/O threads.
+   * @param disk_manager the disk manager that performs the I/O
+   * @param num_threads the number of I/O threads, i.e. the maximum number of requests in flight
+   */
+  explicit AsyncDiskManager(DiskManager *disk_manager, size_t num_threads = DISK_IO_THREADS);
+
+  DISALLOW_COPY_AND_MOVE(AsyncDiskManager);
+
+  /**
+   * @brief Complete all submitted requests, then stop the I/O threads.
+   */
+  ~AsyncDiskManager();
+
+  /**
+   * @brief Queue a request. Requests may complete in any order, so the caller must not submit two requests for the
+   * same page without waiting for the first one.
+   * @param request the request, its callback is fulfilled on completion
+   */
+  void Submit(DiskRequest request);
+
+  /**
+   * @brief Submit a read of page_id into data.
+   * @return a future that becomes ready once the page has been read
+   */
+  auto SubmitRead(page_id_t page_id, char *data) -> std::future<bool>;
+
+  /**
+   * @brief Submit a write of data to page_id.
+   * @return a future that becomes ready once the page has been written
+   */
+  auto SubmitWrite(page_id_t page_id, const char *data) -> std::future<bool>;
+
+  /** @return the disk manager that performs the I/O */
+  auto GetDiskManager() -> DiskManager * { return disk_manager_; }
+
+ private:
+  /** Main loop of an I/O thread. */
+  void ServeRequests();
+
+  DiskManager *disk_manager_;
+  /** Protects queue_ and shutdown_. */
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<DiskRequest> queue_;
+  bool shutdown_{false};
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace bustub
@@ -12,32 +12,70 @@
 
 #pragma once
 
+#include <sys/types.h>
+
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
 namespace bustub {
 
+/**
+ * @brief How fragmented the pages of a database file are, see DiskManager::GetFragmentation().
+ */
+struct DiskFragmentation {
+  /** Pages up to the highest allocated one, i.e. the pages the file has to hold. */
+  size_t num_pages_{0};
+  /** Pages among those that are deallocated and wait for reuse. */
+  size_t num_free_pages_{0};
+  /** Maximal runs of consecutive free pages. */
+  size_t num_free_runs_{0};
+  /** Length of the longest run of consecutive free pages. */
+  size_t largest_free_run_{0};
+
+  /** @return the fraction of num_pages_ that is free, 0 for an empty file */
+  auto FreeRatio() const -> double {
+    return num_pages_ == 0 ? 0 : static_cast<double>(num_free_pages_) / static_cast<double>(num_pages_);
+  }
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Pages are read and written with positional I/O (pread/pwrite) on a raw file descriptor, so there is no shared file
+ * cursor and concurrent ReadPage()/WritePage() calls on different pages do not serialize.
+ *
+ * Which pages are in use is tracked in a free page map, a bitmap with one bit per page. AllocatePage() hands out the
+ * lowest free page, so deallocated pages are reused before the file grows. The bitmap is kept in dedicated pages of
+ * the database file: every FREE_MAP_PAGE_SPAN data pages are preceded by the map page that covers them. The file
+ * starts with a header page holding DB_FILE_MAGIC and DB_FILE_VERSION, so page_id lives at file page
+ * page_id + page_id / FREE_MAP_PAGE_SPAN + 2, and opening a file without that header throws. The map is read when the
+ * file is opened. A dirty map page is written before any page it covers, so that a page whose data is in the file is
+ * never handed out again after a process crash; WriteFreePageMap() and ShutDown() write the rest. Neither write is
+ * followed by fsync(), so the order is not guaranteed to survive an OS crash or power loss. Disk managers that keep
+ * pages in memory only keep the map in memory.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io open the database file with O_DIRECT, bypassing the OS page cache that would otherwise cache
+   * every page a second time behind the buffer pool. Falls back to buffered I/O if the file system refuses it. Page
+   * buffers that are not BUSTUB_PAGE_SIZE aligned go through a bounce buffer.
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool direct_io = false);
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -45,19 +83,46 @@ class DiskManager {
   void ShutDown();
 
   /**
-   * Write a page to the database file.
+   * Write a page to the database file. Throws Exception if the write fails.
    * @param page_id id of the page
    * @param page_data raw page data
    */
   virtual void WritePage(page_id_t page_id, const char *page_data);
 
   /**
-   * Read a page from the database file.
+   * Read a page from the database file, a zeroed page if it was never written. Throws Exception if the read fails.
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Allocate a page, reusing the lowest deallocated page if there is one.
+   * @param stride only hand out page ids congruent to offset modulo stride, e.g. for one instance of a parallel buffer
+   * pool
+   * @param offset see stride, must be less than stride
+   * @return the id of the allocated page
+   */
+  auto AllocatePage(uint32_t stride = 1, uint32_t offset = 0) -> page_id_t;
+
+  /**
+   * Give a page back for reuse. Does nothing if the page is not allocated.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /** @return true if page_id has been allocated and not deallocated since */
+  auto IsAllocated(page_id_t page_id) -> bool;
+
+  /**
+   * Write the pages of the free page map that changed since they were last written to the database file. No-op for
+   * disk managers without a file.
+   */
+  void WriteFreePageMap();
+
+  /** @return how fragmented the allocated pages are */
+  auto GetFragmentation() -> DiskFragmentation;
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -83,6 +148,9 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /** @return true if the database file is accessed with direct I/O */
+  auto IsDirectIO() const -> bool { return direct_io_; }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -93,19 +161,62 @@ class DiskManager {
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
  protected:
-  auto GetFileSize(const std::string &file_name) -> int;
+  /** Number of pages whose allocation state one page of the free page map holds. */
+  static constexpr size_t FREE_MAP_PAGE_SPAN = BUSTUB_PAGE_SIZE * 8;
+  static constexpr size_t FREE_MAP_WORDS_PER_PAGE = FREE_MAP_PAGE_SPAN / 64;
+  /** The header page starts with these bytes, followed by DB_FILE_VERSION. */
+  static constexpr char DB_FILE_MAGIC[8] = {'B', 'U', 'S', 'T', 'U', 'B', 'D', 'B'};
+  /** Bumped whenever the layout of the db file changes. */
+  static constexpr uint32_t DB_FILE_VERSION = 1;
+
+  /** @return the file offset of page_id, which is shifted by the map pages in front of it */
+  static auto PageOffset(page_id_t page_id) -> off_t;
+  /** @return the file offset of the free page map page with the given index */
+  static auto MapPageOffset(size_t map_page) -> off_t;
+
+  /** Write one page worth of data at offset of the db file. Throws Exception on an I/O error. */
+  void WriteAt(off_t offset, const char *page_data);
+  /**
+   * Read one page worth of data at offset of the db file, a zeroed page if it lies past the end of the file. Throws
+   * Exception on an I/O error or if the file ends inside the page.
+   */
+  void ReadAt(off_t offset, char *page_data);
+
+  /** Check the header of the db file, or write it if the file is new, and read the free page map. */
+  void ReadFreePageMap();
+  /** Write the dirty pages of the free page map. Caller should hold free_map_latch_. */
+  void WriteFreePageMapLocked();
+  /** Write one page of the free page map and mark it clean. Caller should hold free_map_latch_. */
+  void WriteMapPageLocked(size_t map_page);
+  /** @return true if page_id is allocated. Caller should hold free_map_latch_. */
+  auto IsAllocatedLocked(page_id_t page_id) const -> bool;
+  /** Set the bit of page_id in the free page map, growing the map if needed. Caller should hold free_map_latch_. */
+  void SetAllocatedLocked(page_id_t page_id, bool allocated);
+
+  auto GetFileSize(const std::string &file_name) -> off_t;
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // file descriptor of the db file, -1 once it is closed
+  int db_fd_{-1};
+  // true if db_fd_ was opened with O_DIRECT
+  bool direct_io_{false};
   std::string file_name_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
-  // With multiple buffer pool instances, need to protect file access
+  // Protects opening and closing the db file, page I/O itself needs no latch
   std::mutex db_io_latch_;
+
+  // Protects the free page map
+  std::mutex free_map_latch_;
+  // One bit per page, set if the page is allocated. Always a whole number of map pages long.
+  std::vector<uint64_t> free_map_;
+  // free_map_dirty_[i] is true if map page i changed since it was last written
+  std::vector<bool> free_map_dirty_;
+  // alloc_hints_[offset] is the lowest page id of that residue that may be free, for the stride last allocated with
+  std::vector<page_id_t> alloc_hints_;
 };
 
 }  // namespace bustub
@@ -11,12 +11,15 @@
 #pragma once
 
 #include <algorithm>
+#include <condition_variable>  // NOLINT
 #include <deque>
 #include <iostream>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <queue>
 #include <shared_mutex>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "common/config.h"
@@ -53,9 +56,29 @@ class Context {
   // You may want to use this when getting value, but not necessary.
   std::deque<ReadPageGuard> read_set_;
 
+  // Pages emptied by merges. They are deleted once every guard has been dropped.
+  std::vector<page_id_t> deleted_pages_;
+
   auto IsRootPage(page_id_t page_id) -> bool { return page_id == root_page_id_; }
 };
 
+/**
+ * @brief A range scan over a B+ tree, see BPlusTree::ScanRange(). A missing bound leaves that end of the range open.
+ */
+template <typename KeyType>
+struct KeyRangeScan {
+  // BPlusTree::ScanRange() moves the bound the scan starts from past every batch it returns: the lower bound of a
+  // forward scan, the upper bound of a reverse one.
+  std::optional<KeyType> lower_;
+  bool lower_inclusive_{true};
+  std::optional<KeyType> upper_;
+  bool upper_inclusive_{true};
+  // Whether the keys are returned in descending order.
+  bool reverse_{false};
+  // Set by BPlusTree::ScanRange() once the range is exhausted.
+  bool done_{false};
+};
+
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
 // Main class providing the API for the Interactive B+ Tree.
@@ -63,12 +86,15 @@ INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  friend class IndexIterator<KeyType, ValueType, KeyComparator>;
 
  public:
   explicit BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
                      const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
                      int internal_max_size = INTERNAL_PAGE_SIZE);
 
+  ~BPlusTree() { StopBackgroundCompaction(); }
+
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
@@ -78,9 +104,70 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *txn);
 
+  /**
+   * @brief Switch Remove() to lazy merging. A remove then only latches its leaf, like any remove that leaves the leaf
+   * at least half full, and never merges or redistributes: a leaf that drops below merge_threshold of its max size is
+   * queued for CompactUnderflows() instead. Until then leaves may run below their minimum size, down to empty, which
+   * lookups, scans and inserts all handle. Call this before the tree is shared between threads.
+   *
+   * @param merge_threshold fill ratio of the max leaf size below which a leaf is rebalanced; the resulting size is
+   * kept between one entry (only empty leaves are merged) and the minimum leaf size (as eager as Remove() otherwise).
+   * Leaves of variable-length keys must also be below that ratio of their bytes.
+   */
+  void EnableLazyMerge(double merge_threshold = LAZY_MERGE_THRESHOLD);
+
+  /**
+   * @brief Merge or redistribute the leaves queued by lazy removes that are still below the merge threshold. Each
+   * leaf takes one pessimistic descent of its own, so the write latches on its path are held only for that leaf.
+   *
+   * @param max_leaves the most queued leaves to process
+   * @return the number of queued leaves processed
+   */
+  auto CompactUnderflows(size_t max_leaves = SIZE_MAX) -> size_t;
+
+  /**
+   * @brief Start a background thread that runs CompactUnderflows() whenever lazy removes have queued leaves, see
+   * EnableLazyMerge(). No-op if it is already running.
+   */
+  void StartBackgroundCompaction();
+
+  /**
+   * @brief Stop the background compaction thread and wait for it to finish the leaf it is compacting. Queued leaves
+   * stay queued. No-op if it is not running.
+   */
+  void StopBackgroundCompaction();
+
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
+  /**
+   * @brief Build the tree bottom-up from entries sorted by key, which is much cheaper than inserting them one by one:
+   * leaves are filled left to right and linked, then each internal level is built over the one below it. Nodes are
+   * filled to fill_factor of their max size; the last node of a level is merged with or balanced against its left
+   * neighbour so that no node ends up below the minimum size.
+   *
+   * @param items the entries, in strictly increasing key order
+   * @param fill_factor fraction of the max size each node is filled to
+   * @return false if the tree is not empty or the keys are not strictly increasing, in which case nothing is built
+   */
+  auto BulkLoad(const std::vector<MappingType> &items, double fill_factor = BULK_LOAD_FILL_FACTOR,
+                Transaction *txn = nullptr) -> bool;
+
+  /**
+   * @brief Fetch the next batch of a range scan: the values of the keys in the range that live in the next leaf that
+   * has any, read under a single latch. Every batch descends from the root again instead of following the leaf chain
+   * across batches, so the scan never holds a latch in between; that also makes reverse scans possible without
+   * backward leaf links. To stop early, stop asking for batches.
+   *
+   * @param scan the bounds of the scan, advanced past the returned batch
+   * @param result the values are appended here
+   * @return false once the scan is done, in which case nothing was appended
+   */
+  auto ScanRange(KeyRangeScan<KeyType> *scan, std::vector<ValueType> *result) -> bool;
+
+  /** ScanRange() that returns the keys along with the values. */
+  auto ScanRange(KeyRangeScan<KeyType> *scan, std::vector<MappingType> *result) -> bool;
+
   // Return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
@@ -117,6 +204,72 @@ class BPlusTree {
   void RemoveFromFile(const std::string &file_name, Transaction *txn = nullptr);
 
  private:
+  /**
+   * @brief Descent for readers with latch crabbing, to the leaf covering key, or to the leftmost leaf without a key.
+   *
+   * @param[out] high_key set to the smallest separator above the path taken, so every key of the leaf is below it and
+   * every key of the following leaves is at least as large; left empty on the rightmost path
+   * @return the read-latched leaf, or std::nullopt if the tree is empty
+   */
+  auto FindLeafRead(const std::optional<KeyType> &key, std::optional<KeyType> *high_key) const
+      -> std::optional<ReadPageGuard>;
+
+  /**
+   * @brief Optimistic descent for writers: read-latches the path from the header down and write-latches only the
+   * leaf, releasing every ancestor on the way. Sets ctx.root_page_id_.
+   *
+   * @return the write-latched leaf covering key, or std::nullopt if the tree is empty
+   */
+  auto FindLeafOptimistic(const KeyType &key, Context &ctx) -> std::optional<WritePageGuard>;
+
+  /**
+   * @brief Pessimistic descent for writers: write-latches the header and the path down to the leaf covering key
+   * into ctx, releasing the ancestors above every node that is_safe accepts. The leaf ends up at the back of
+   * ctx.write_set_.
+   */
+  template <typename SafePredicate>
+  void FindLeafPessimistic(const KeyType &key, Context &ctx, SafePredicate &&is_safe);
+
+  /** Inserts (key, right_page_id) next to the page at the back of ctx.write_set_, which is then released. */
+  void InsertIntoParent(Context &ctx, const KeyType &key, page_id_t right_page_id);
+
+  /**
+   * @brief Merges or redistributes the page at the back of ctx.write_set_ and its ancestors until none is underfull.
+   * A page of variable-length keys whose sibling's entry or new separator does not fit is left underfull.
+   *
+   * @return whether anything changed
+   */
+  auto HandleUnderflow(Context &ctx) -> bool;
+
+  /** IsUnderfull() and IsSafeToRemove() of the leaf or internal page behind page. */
+  static auto IsUnderfull(const BPlusTreePage *page) -> bool;
+  static auto IsSafeToRemove(const BPlusTreePage *page) -> bool;
+
+  /** Drops every guard of ctx and deletes the pages it emptied. */
+  void ReleaseContext(Context &ctx);
+
+  /** Rebalances the leaf key leads to if it is below the lazy merge threshold. @return whether anything changed */
+  auto CompactLeaf(const KeyType &key) -> bool;
+
+  /** Main loop of the background compaction thread. */
+  void BackgroundCompaction();
+
+  /** ScanRange() for forward and for reverse scans, returning values or entries. */
+  template <typename Entry>
+  auto ScanRangeForward(KeyRangeScan<KeyType> *scan, std::vector<Entry> *result) -> bool;
+  template <typename Entry>
+  auto ScanRangeReverse(KeyRangeScan<KeyType> *scan, std::vector<Entry> *result) -> bool;
+
+  static void AppendEntry(const LeafPage *leaf, int index, std::vector<ValueType> *result) {
+    result->push_back(leaf->ValueAt(index));
+  }
+  static void AppendEntry(const LeafPage *leaf, int index, std::vector<MappingType> *result) {
+    result->emplace_back(leaf->KeyAt(index), leaf->ValueAt(index));
+  }
+
+  /** Allocates a page and returns it write-latched. */
+  auto NewPageWrite(page_id_t *page_id) -> WritePageGuard;
+
   /* Debug Routines for FREE!! */
   void ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out);
 
@@ -138,6 +291,16 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+
+  /** Leaves below this fill ratio are compacted later, none unless EnableLazyMerge() was called. */
+  std::optional<double> lazy_merge_threshold_;
+  /** For each leaf queued by a lazy remove, the removed key, which leads to that leaf or the one that absorbed it. */
+  std::mutex underflow_latch_;
+  std::deque<KeyType> underflow_keys_;
+  /** The background compaction thread, see StartBackgroundCompaction(). */
+  std::thread compaction_thread_;
+  std::condition_variable compaction_cv_;
+  bool compaction_running_{false};
 };
 
 /**
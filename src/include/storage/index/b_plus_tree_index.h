@@ -35,6 +35,35 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * @brief Build the tree key of an index entry: the encoded key columns, included columns last, and, for non-unique
+   * indexes, the RID as a suffix, which makes every entry distinct.
+   */
+  auto MakeKey(const Tuple &key, RID rid) const -> KeyType;
+
+  /**
+   * @brief Build a key that bounds all entries whose leading key columns equal prefix: the remaining columns and the
+   * RID suffix are filled with their smallest values, or with their largest ones if fill_high is set.
+   */
+  auto MakeBoundKey(const std::vector<Value> &prefix, bool fill_high) const -> KeyType;
+
+  /**
+   * @brief Fill the empty index with entries in any order, keyed by MakeKey(). They are sorted and handed to
+   * BPlusTree::BulkLoad().
+   * @return false if two entries have the same key, as the rows of a unique index may; the index is left empty
+   */
+  auto BulkLoad(std::vector<MappingType> entries, Transaction *transaction) -> bool;
+
+  /**
+   * @brief Fetch the next batch of RIDs of a range scan, see BPlusTree::ScanRange().
+   */
+  auto ScanRange(KeyRangeScan<KeyType> *scan, std::vector<RID> *result) -> bool;
+
+  /**
+   * @brief ScanRange() that returns the keys too, from which index-only scans read the key and included columns.
+   */
+  auto ScanRange(KeyRangeScan<KeyType> *scan, std::vector<MappingType> *result) -> bool;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -50,7 +79,8 @@ class BPlusTreeIndex : public Index {
 
 /** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
 
-constexpr static const auto TWO_INTEGER_SIZE = 8;
+// Two INTEGER columns and the RID suffix of non-unique indexes.
+constexpr static const auto TWO_INTEGER_SIZE = 16;
 using IntegerKeyType = GenericKey<TWO_INTEGER_SIZE>;
 using IntegerValueType = RID;
 using IntegerComparatorType = GenericComparator<TWO_INTEGER_SIZE>;
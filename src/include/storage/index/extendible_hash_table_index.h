@@ -23,13 +23,13 @@
 
 namespace bustub {
 
-#define HASH_TABLE_INDEX_TYPE ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>
+#define HASH_TABLE_INDEX_TYPE ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator, HashFn>
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn = HashFunction<KeyType>>
 class ExtendibleHashTableIndex : public Index {
  public:
   ExtendibleHashTableIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
-                           const HashFunction<KeyType> &hash_fn);
+                           const HashFn &hash_fn);
 
   ~ExtendibleHashTableIndex() override = default;
 
@@ -43,7 +43,7 @@ class ExtendibleHashTableIndex : public Index {
   // comparator for key
   KeyComparator comparator_;
   // container
-  DiskExtendibleHashTable<KeyType, ValueType, KeyComparator> container_;
+  DiskExtendibleHashTable<KeyType, ValueType, KeyComparator, HashFn> container_;
 };
 
 }  // namespace bustub
@@ -13,9 +13,12 @@
 #pragma once
 
 #include <cstring>
+#include <string>
 
+#include "common/macros.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -25,42 +28,79 @@ namespace bustub {
  * This key type uses an fixed length array to hold data for indexing
  * purposes, the actual size of which is specified and instantiated
  * with a template argument.
+ *
+ * The key columns are stored in a binary-comparable encoding, so that two keys compare like their bytes do and
+ * GenericComparator is a single memcmp:
+ * - integers are stored big-endian with the sign bit flipped, timestamps big-endian, and decimals big-endian after
+ *   flipping the sign bit of positive and all bits of negative numbers;
+ * - NULLs of fixed-width columns are their BusTub NULL sentinels, encoded like any other value of the type. No value
+ *   that is not NULL shares a sentinel, so NULL integers sort first, NULL decimals before every finite number and NULL
+ *   timestamps last;
+ * - a VARCHAR starts with a null byte (0 for NULL, 1 otherwise), stores its 0x00 bytes as 0x00 0xFF and ends with
+ *   0x00 0x00, so a string sorts before its extensions whatever columns follow it.
+ * Columns that do not fit into KeySize are cut off.
  */
 template <size_t KeySize>
 class GenericKey {
  public:
-  inline void SetFromKey(const Tuple &tuple) {
+  /** The size of the RID suffix, see SetRid(). */
+  static constexpr size_t RID_SUFFIX_SIZE = 8;
+
+  /**
+   * @brief Encode the columns of a key tuple.
+   * @param tuple the key tuple, e.g. built by Tuple::KeyFromTuple()
+   * @param key_schema the schema of the key tuple
+   */
+  inline void SetFromKey(const Tuple &tuple, const Schema &key_schema) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    size_t offset = 0;
+    for (uint32_t i = 0; i < key_schema.GetColumnCount(); i++) {
+      offset = EncodeValue(tuple.GetValue(&key_schema, i), offset);
+    }
   }
 
   // NOTE: for test purpose only
+  // encodes key as a single BIGINT column
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
-    memcpy(data_, &key, sizeof(int64_t));
+    EncodeValue(Value(TypeId::BIGINT, key), 0);
   }
 
   inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
-    const char *data_ptr;
-    const auto &col = schema->GetColumn(column_idx);
-    const TypeId column_type = col.GetType();
-    const bool is_inlined = col.IsInlined();
-    if (is_inlined) {
-      data_ptr = (data_ + col.GetOffset());
-    } else {
-      int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + col.GetOffset()));
-      data_ptr = (data_ + offset);
+    size_t offset = 0;
+    for (uint32_t i = 0; i < column_idx; i++) {
+      offset = DecodeValue(schema->GetColumn(i).GetType(), offset, nullptr);
     }
-    return Value::DeserializeFrom(data_ptr, column_type);
+    Value value;
+    DecodeValue(schema->GetColumn(column_idx).GetType(), offset, &value);
+    return value;
+  }
+
+  /**
+   * @brief Store a RID in the last RID_SUFFIX_SIZE bytes, after the key columns. Non-unique indexes keep one entry per
+   * (key, RID) pair this way, so the entries of a key are adjacent and ordered by RID.
+   */
+  inline void SetRid(const RID &rid) {
+    static_assert(KeySize >= RID_SUFFIX_SIZE, "key too small for a RID suffix");
+    size_t offset = PutBytes(static_cast<uint32_t>(rid.GetPageId()) ^ 0x80000000U, 4, KeySize - RID_SUFFIX_SIZE);
+    PutBytes(rid.GetSlotNum(), 4, offset);
+  }
+
+  inline auto GetRid() const -> RID {
+    static_assert(KeySize >= RID_SUFFIX_SIZE, "key too small for a RID suffix");
+    auto page_id = static_cast<page_id_t>(GetBytes(KeySize - RID_SUFFIX_SIZE, 4) ^ 0x80000000U);
+    return {page_id, static_cast<uint32_t>(GetBytes(KeySize - RID_SUFFIX_SIZE + 4, 4))};
   }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
-  inline auto ToString() const -> int64_t { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
+  // decode the key as a single BIGINT column
+  inline auto ToString() const -> int64_t {
+    return static_cast<int64_t>(GetBytes(0, sizeof(int64_t)) ^ (uint64_t{1} << 63));
+  }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
+  // decode the key as a single BIGINT column
   friend auto operator<<(std::ostream &os, const GenericKey &key) -> std::ostream & {
     os << key.ToString();
     return os;
@@ -68,39 +108,221 @@ class GenericKey {
 
   // actual location of data, extends past the end.
   char data_[KeySize];
+
+ private:
+  /** Writes the low width bytes of bytes big-endian at offset, as far as they fit. @return the offset after them */
+  inline auto PutBytes(uint64_t bytes, size_t width, size_t offset) -> size_t {
+    for (size_t i = 0; i < width; i++, offset++) {
+      if (offset < KeySize) {
+        data_[offset] = static_cast<char>(bytes >> (8 * (width - 1 - i)));
+      }
+    }
+    return offset;
+  }
+
+  /** Reads width bytes big-endian from offset; bytes that were cut off read as zero. */
+  inline auto GetBytes(size_t offset, size_t width) const -> uint64_t {
+    uint64_t bytes = 0;
+    for (size_t i = 0; i < width; i++, offset++) {
+      bytes = (bytes << 8) | (offset < KeySize ? static_cast<uint8_t>(data_[offset]) : 0);
+    }
+    return bytes;
+  }
+
+  inline auto EncodeValue(const Value &value, size_t offset) -> size_t {
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return PutBytes(value.IsNull() ? 0 : static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80U, 1, offset);
+      case TypeId::SMALLINT:
+        return PutBytes(value.IsNull() ? 0 : static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000U, 2, offset);
+      case TypeId::INTEGER:
+        return PutBytes(value.IsNull() ? 0 : static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, 4, offset);
+      case TypeId::BIGINT:
+        return PutBytes(value.IsNull() ? 0 : static_cast<uint64_t>(value.GetAs<int64_t>()) ^ (uint64_t{1} << 63), 8,
+                        offset);
+      case TypeId::TIMESTAMP:
+        return PutBytes(value.GetAs<uint64_t>(), 8, offset);
+      case TypeId::DECIMAL: {
+        auto number = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &number, sizeof(bits));
+        return PutBytes((bits >> 63) != 0 ? ~bits : bits ^ (uint64_t{1} << 63), 8, offset);
+      }
+      case TypeId::VARCHAR: {
+        if (value.IsNull()) {
+          return PutBytes(0, 1, offset);
+        }
+        offset = PutBytes(1, 1, offset);
+        // The length of a VARCHAR value counts its terminating '\0'.
+        const char *chars = value.GetData();
+        for (uint32_t i = 0; i + 1 < value.GetLength(); i++) {
+          offset = PutBytes(static_cast<uint8_t>(chars[i]), 1, offset);
+          if (chars[i] == '\0') {
+            offset = PutBytes(0xFF, 1, offset);
+          }
+        }
+        return PutBytes(0, 2, offset);
+      }
+      default:
+        UNREACHABLE("cannot encode a key column of this type");
+    }
+  }
+
+  /** Decodes the column of type type at offset into *value unless it is nullptr. @return the offset after it */
+  inline auto DecodeValue(TypeId type, size_t offset, Value *value) const -> size_t {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        if (value != nullptr) {
+          *value = Value(type, static_cast<int8_t>(GetBytes(offset, 1) ^ 0x80U));
+        }
+        return offset + 1;
+      case TypeId::SMALLINT:
+        if (value != nullptr) {
+          *value = Value(type, static_cast<int16_t>(GetBytes(offset, 2) ^ 0x8000U));
+        }
+        return offset + 2;
+      case TypeId::INTEGER:
+        if (value != nullptr) {
+          *value = Value(type, static_cast<int32_t>(GetBytes(offset, 4) ^ 0x80000000U));
+        }
+        return offset + 4;
+      case TypeId::BIGINT:
+        if (value != nullptr) {
+          *value = Value(type, static_cast<int64_t>(GetBytes(offset, 8) ^ (uint64_t{1} << 63)));
+        }
+        return offset + 8;
+      case TypeId::TIMESTAMP:
+        // a Value of the sentinel is NULL
+        if (value != nullptr) {
+          *value = Value(type, GetBytes(offset, 8));
+        }
+        return offset + 8;
+      case TypeId::DECIMAL:
+        if (value != nullptr) {
+          uint64_t bits = GetBytes(offset, 8);
+          bits = (bits >> 63) != 0 ? bits ^ (uint64_t{1} << 63) : ~bits;
+          double number;
+          memcpy(&number, &bits, sizeof(number));
+          *value = Value(type, number);
+        }
+        return offset + 8;
+      case TypeId::VARCHAR: {
+        if (GetBytes(offset, 1) == 0) {
+          if (value != nullptr) {
+            *value = ValueFactory::GetNullValueByType(type);
+          }
+          return offset + 1;
+        }
+        std::string chars;
+        for (offset++; offset < KeySize; offset++) {
+          char c = data_[offset];
+          if (c == '\0') {
+            if (GetBytes(offset + 1, 1) != 0xFF) {
+              offset += 2;
+              break;
+            }
+            offset++;
+          }
+          chars.push_back(c);
+        }
+        if (value != nullptr) {
+          *value = Value(type, chars);
+        }
+        return offset;
+      }
+      default:
+        UNREACHABLE("cannot decode a key column of this type");
+    }
+  }
 };
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Keys are binary-comparable (see GenericKey), so this is a memcmp and never needs to look at the key schema.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
-    uint32_t column_count = key_schema_->GetColumnCount();
+    int result = memcmp(lhs.data_, rhs.data_, KeySize);
+    return (result > 0) - (result < 0);
+  }
 
-    for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
+  GenericComparator(const GenericComparator &other) = default;
 
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
-      }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
-      }
-    }
-    // equals
-    return 0;
+  // constructor
+  explicit GenericComparator(Schema * /* key_schema */) {}
+};
+
+/**
+ * @brief Lets B+ tree pages compare keys as unsigned integers instead of calling the comparator. It is only
+ * specialized for GenericKeys that fit into a machine word, ordered by GenericComparator: their memcmp order is the
+ * order of the big-endian integer made of their bytes.
+ */
+template <typename KeyType, typename KeyComparator>
+struct KeyAsWord {
+  static constexpr bool ENABLED = false;
+};
+
+template <>
+struct KeyAsWord<GenericKey<8>, GenericComparator<8>> {
+  static constexpr bool ENABLED = true;
+  static inline auto Get(const GenericKey<8> &key) -> uint64_t {
+    uint64_t word;
+    memcpy(&word, key.data_, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
   }
+};
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+template <>
+struct KeyAsWord<GenericKey<16>, GenericComparator<16>> {
+  static constexpr bool ENABLED = true;
+  static inline auto Get(const GenericKey<16> &key) -> unsigned __int128 {
+    uint64_t high;
+    uint64_t low;
+    memcpy(&high, key.data_, sizeof(high));
+    memcpy(&low, key.data_ + sizeof(high), sizeof(low));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    high = __builtin_bswap64(high);
+    low = __builtin_bswap64(low);
+#endif
+    return (static_cast<unsigned __int128>(high) << 64) | low;
+  }
+};
 
-  // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+template <>
+struct KeyAsWord<GenericKey<4>, GenericComparator<4>> {
+  static constexpr bool ENABLED = true;
+  static inline auto Get(const GenericKey<4> &key) -> uint32_t {
+    uint32_t word;
+    memcpy(&word, key.data_, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    word = __builtin_bswap32(word);
+#endif
+    return word;
+  }
+};
 
- private:
-  Schema *key_schema_;
+/**
+ * @brief Lets B+ tree pages store keys as variable-length byte strings, see SlottedEntries. Like KeyAsWord it relies
+ * on GenericComparator comparing the bytes of GenericKeys; it also relies on the zero bytes that pad a GenericKey after
+ * its last column, which can be dropped and put back. It is specialized for the GenericKeys that are too wide for
+ * KeyAsWord, which are the ones VARCHAR and multi-column keys need.
+ */
+template <typename KeyType, typename KeyComparator>
+struct KeyAsBytes {
+  static constexpr bool ENABLED = false;
+};
+
+template <size_t KeySize>
+struct KeyAsBytes<GenericKey<KeySize>, GenericComparator<KeySize>> {
+  static constexpr bool ENABLED = !KeyAsWord<GenericKey<KeySize>, GenericComparator<KeySize>>::ENABLED;
 };
 
 }  // namespace bustub
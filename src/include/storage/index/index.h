@@ -43,10 +43,17 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param is_unique Whether every key maps to at most one RID
+   * @param included_column_count How many of the trailing key_attrs are included columns, which are stored with
+   * every entry for index-only scans but are not part of the search key
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, bool is_unique = true, uint32_t included_column_count = 0)
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        is_unique_(is_unique),
+        included_column_count_(included_column_count) {
     key_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, key_attrs_));
   }
 
@@ -72,6 +79,15 @@ class IndexMetadata {
   /** @return The mapping relation between indexed columns and base table columns */
   inline auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
 
+  /** @return Whether every key maps to at most one RID */
+  inline auto IsUnique() const -> bool { return is_unique_; }
+
+  /** @return The number of included columns at the end of the index key, see the constructor */
+  inline auto GetIncludedColumnCount() const -> uint32_t { return included_column_count_; }
+
+  /** @return The number of columns of the search key, which precede the included columns */
+  inline auto GetSearchColumnCount() const -> uint32_t { return GetIndexColumnCount() - included_column_count_; }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -92,6 +108,10 @@ class IndexMetadata {
   std::string table_name_;
   /** The mapping relation between key schema and tuple schema */
   const std::vector<uint32_t> key_attrs_;
+  /** Whether every key maps to at most one RID */
+  bool is_unique_;
+  /** The number of included columns at the end of key_attrs_ */
+  uint32_t included_column_count_;
   /** The schema of the indexed key */
   std::shared_ptr<Schema> key_schema_;
 };
@@ -13,31 +13,68 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <optional>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * @brief Forward iterator over the leaf level of a B+ tree. The iterator keeps the current leaf read-latched, and
+ * lets go of it before latching the next one, so it never holds two leaf latches at once. Once the leaf is released,
+ * its sibling pointer may name a page that was merged away and reused, so the next leaf is found from the root with
+ * the high key of the current one instead.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
+  /** Creates the end iterator. */
   IndexIterator();
+
+  /**
+   * @brief Creates an iterator positioned at index of the leaf held by guard. An index past the end of the leaf moves
+   * the iterator on to the following leaves.
+   * @param high_key the smallest separator above the leaf, see BPlusTree::FindLeafRead(), empty for the last leaf
+   */
+  IndexIterator(const BPlusTree<KeyType, ValueType, KeyComparator> *tree, ReadPageGuard guard, int index,
+                std::optional<KeyType> high_key);
+
   ~IndexIterator();  // NOLINT
 
+  IndexIterator(IndexIterator &&that) noexcept = default;
+  auto operator=(IndexIterator &&that) noexcept -> IndexIterator & = default;
+
   auto IsEnd() -> bool;
 
   auto operator*() -> const MappingType &;
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator==(const IndexIterator &itr) const -> bool {
+    return page_id_ == itr.page_id_ && index_ == itr.index_;
+  }
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  /** Moves on to the next leaf while the current one is exhausted, ending up at the end iterator after the last. */
+  void SkipExhaustedLeaves();
+
+  const BPlusTree<KeyType, ValueType, KeyComparator> *tree_{nullptr};
+  ReadPageGuard guard_;
+  std::optional<KeyType> high_key_;
+  page_id_t page_id_{INVALID_PAGE_ID};
+  int index_{0};
+  /** The entry operator*() returned last; leaves of variable-length keys do not store whole entries to point to. */
+  MappingType item_;
 };
 
 }  // namespace bustub
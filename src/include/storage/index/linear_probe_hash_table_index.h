@@ -23,13 +23,13 @@
 
 namespace bustub {
 
-#define HASH_TABLE_INDEX_TYPE LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>
+#define HASH_TABLE_INDEX_TYPE LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator, HashFn>
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashFn = HashFunction<KeyType>>
 class LinearProbeHashTableIndex : public Index {
  public:
   LinearProbeHashTableIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
-                            size_t num_buckets, const HashFunction<KeyType> &hash_fn);
+                            size_t num_buckets, const HashFn &hash_fn);
 
   ~LinearProbeHashTableIndex() override = default;
 
@@ -43,7 +43,7 @@ class LinearProbeHashTableIndex : public Index {
   // comparator for key
   KeyComparator comparator_;
   // container
-  LinearProbeHashTable<KeyType, ValueType, KeyComparator> container_;
+  LinearProbeHashTable<KeyType, ValueType, KeyComparator, HashFn> container_;
 };
 
 }  // namespace bustub
@@ -12,14 +12,17 @@
 
 #include <queue>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "storage/page/b_plus_tree_page.h"
+#include "storage/page/b_plus_tree_slotted_entries.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 12
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_SIZE (B_PLUS_TREE_INTERNAL_PAGE_TYPE::MAX_SIZE)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -32,6 +35,11 @@ namespace bustub {
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ * Keys that KeyAsBytes enables are stored as variable-length byte strings instead, see SlottedEntries. The tree then
+ * picks the shortest separators it can (prefix truncation, see ShortestSeparator()). Such a page counts as full while
+ * a separator of the full key size would not fit, and it is underfull once it is below half of both its max size and
+ * its bytes.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -40,6 +48,14 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   BPlusTreeInternalPage() = delete;
   BPlusTreeInternalPage(const BPlusTreeInternalPage &other) = delete;
 
+  /** Whether keys are stored as variable-length byte strings. */
+  static constexpr bool VARIABLE_LENGTH = KeyAsBytes<KeyType, KeyComparator>::ENABLED;
+  using SlottedEntriesType = SlottedEntries<KeyType, ValueType, BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE, false>;
+  /** The default max size, as many entries as fit. */
+  static constexpr int MAX_SIZE =
+      VARIABLE_LENGTH ? SlottedEntriesType::MAX_ENTRIES
+                      : static_cast<int>((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(MappingType));
+
   /**
    * Writes the necessary header information to a newly created page, must be called after
    * the creation of a new page to make a valid BPlusTreeInternalPage
@@ -63,6 +79,7 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   /**
    *
    * @param value the value to search for
+   * @return the index of value, or -1 if the page does not hold it
    */
   auto ValueIndex(const ValueType &value) const -> int;
 
@@ -73,6 +90,70 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    */
   auto ValueAt(int index) const -> ValueType;
 
+  /**
+   *
+   * @param index the index
+   * @param value the new value at the index
+   */
+  void SetValueAt(int index, const ValueType &value);
+
+  /**
+   * @param key the key to look up
+   * @param comparator the key comparator
+   * @return the index of the child whose subtree covers key
+   */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /** @return whether a separator may not fit without a split, whatever it is */
+  auto IsFull() const -> bool;
+
+  /** @return whether the page is below its minimum fill and has to be merged or redistributed */
+  auto IsUnderfull() const -> bool;
+
+  /** @return whether the page stays at its minimum fill whichever entry is removed */
+  auto IsSafeToRemove() const -> bool;
+
+  /** @return whether the key at index can be replaced by key; it may be longer */
+  auto CanSetKeyAt(int index, const KeyType &key) const -> bool;
+
+  /** @return whether the entries of right, the next page, fit into this one with separator as the key of its first */
+  auto CanAbsorb(const BPlusTreeInternalPage *right, const KeyType &separator) const -> bool;
+
+  /**
+   * @param items the entries of a full page and the one to insert
+   * @return how many of items to keep in this page when splitting, the rest go to the new page
+   */
+  auto SplitPoint(const std::vector<MappingType> &items) const -> int;
+
+  /** @return the sizes of the internal pages that BPlusTree::BulkLoad() puts the items of a level into */
+  static auto BulkLoadSizes(const std::vector<MappingType> &items, int max_size, double fill_factor)
+      -> std::vector<int>;
+
+  /**
+   * @return a separator for two neighbouring pages, greater than left, the last key of the left page, and at most
+   * right, the first key of the right page. With variable-length keys it is the shortest such prefix of right,
+   * otherwise right itself.
+   */
+  static auto ShortestSeparator(const KeyType &left, const KeyType &right) -> KeyType;
+
+  /**
+   * @brief Insert a key and child at index, shifting the later entries back. The page must not be full. An empty page
+   * starts over, so refilling a page only takes SetSize(0).
+   */
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+
+  /**
+   * @brief Remove the entry at index, shifting the later entries forward.
+   */
+  void RemoveAt(int index);
+
+  /**
+   * @brief Append the entries from index on to the end of recipient and remove them from this page. The key at index
+   * is moved as well, so when it becomes the first key of recipient the caller has to push it up or pull the parent's
+   * separator down into it.
+   */
+  void MoveSuffixTo(int index, BPlusTreeInternalPage *recipient);
+
   /**
    * @brief For test only, return a string representing all keys in
    * this internal page, formatted as "(key1,key2,key3,...)"
@@ -100,6 +181,9 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
  private:
+  auto Entries() const -> const SlottedEntriesType * { return reinterpret_cast<const SlottedEntriesType *>(array_); }
+  auto Entries() -> SlottedEntriesType * { return reinterpret_cast<SlottedEntriesType *>(array_); }
+
   // Flexible array member for page data.
   MappingType array_[0];
 };
@@ -15,12 +15,13 @@
 #include <vector>
 
 #include "storage/page/b_plus_tree_page.h"
+#include "storage/page/b_plus_tree_slotted_entries.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 16
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_SIZE (B_PLUS_TREE_LEAF_PAGE_TYPE::MAX_SIZE)
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
@@ -32,6 +33,10 @@ namespace bustub {
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
+ * Keys that KeyAsBytes enables are stored as variable-length byte strings instead, with the prefix all of them share
+ * stored once (head compression), see SlottedEntries. Such a page is full once the next key does not fit, and it is
+ * underfull once it is below half of both its max size and its bytes.
+ *
  *  Header format (size in byte, 16 bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | CurrentSize (4) | MaxSize (4) |
@@ -47,6 +52,14 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   BPlusTreeLeafPage() = delete;
   BPlusTreeLeafPage(const BPlusTreeLeafPage &other) = delete;
 
+  /** Whether keys are stored as variable-length byte strings. */
+  static constexpr bool VARIABLE_LENGTH = KeyAsBytes<KeyType, KeyComparator>::ENABLED;
+  using SlottedEntriesType = SlottedEntries<KeyType, ValueType, BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE, true>;
+  /** The default max size, as many entries as fit. */
+  static constexpr int MAX_SIZE =
+      VARIABLE_LENGTH ? SlottedEntriesType::MAX_ENTRIES
+                      : static_cast<int>((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType));
+
   /**
    * After creating a new leaf page from buffer pool, must call initialize
    * method to set default values
@@ -58,6 +71,59 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
   auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+  auto ItemAt(int index) const -> MappingType;
+
+  /**
+   * @param key the key to look up
+   * @param comparator the key comparator
+   * @return the index of the first key that is not less than key, GetSize() if there is none
+   */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /** @return whether key can be inserted without a split */
+  auto HasRoomFor(const KeyType &key) const -> bool;
+
+  /** @return whether the page is below its minimum fill and has to be merged or redistributed */
+  auto IsUnderfull() const -> bool;
+
+  /** @return whether the page stays at its minimum fill whichever entry is removed */
+  auto IsSafeToRemove() const -> bool;
+
+  /**
+   * @return whether the page is below merge_threshold of its max fill, kept between empty and the minimum fill; see
+   * BPlusTree::EnableLazyMerge()
+   */
+  auto IsBelowMergeThreshold(double merge_threshold) const -> bool;
+
+  /** @return whether the entries of right, the next page, fit into this one */
+  auto CanAbsorb(const BPlusTreeLeafPage *right) const -> bool;
+
+  /**
+   * @param items the sorted entries of a page that is out of space and the one to insert
+   * @return how many of items to keep in this page when splitting, the rest go to the new page
+   */
+  auto SplitPoint(const std::vector<MappingType> &items) const -> int;
+
+  /** @return the sizes of the leaves that BPlusTree::BulkLoad() puts the sorted items into */
+  static auto BulkLoadSizes(const std::vector<MappingType> &items, int max_size, double fill_factor)
+      -> std::vector<int>;
+
+  /**
+   * @brief Insert a key and value at index, shifting the later entries back. The page must have room for it. An empty
+   * page starts over, so refilling a page only takes SetSize(0).
+   */
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+
+  /**
+   * @brief Remove the entry at index, shifting the later entries forward.
+   */
+  void RemoveAt(int index);
+
+  /**
+   * @brief Append the entries from index on to the end of recipient and remove them from this page.
+   */
+  void MoveSuffixTo(int index, BPlusTreeLeafPage *recipient);
 
   /**
    * @brief for test only return a string representing all keys in
@@ -85,6 +151,9 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   }
 
  private:
+  auto Entries() const -> const SlottedEntriesType * { return reinterpret_cast<const SlottedEntriesType *>(array_); }
+  auto Entries() -> SlottedEntriesType * { return reinterpret_cast<SlottedEntriesType *>(array_); }
+
   page_id_t next_page_id_;
   // Flexible array member for page data.
   MappingType array_[0];
@@ -14,6 +14,7 @@
 #include <climits>
 #include <cstdlib>
 #include <string>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "storage/index/generic_key.h"
@@ -56,11 +57,18 @@ class BPlusTreePage {
   void SetMaxSize(int max_size);
   auto GetMinSize() const -> int;
 
+ protected:
+  /**
+   * @brief Split count entries into the sizes of the pages BPlusTree::BulkLoad() builds for one level, when the page
+   * size is a number of entries.
+   */
+  static auto BulkLoadNodeSizes(int count, int max_size, int min_size, double fill_factor) -> std::vector<int>;
+
  private:
   // member variable, attributes that both internal and leaf page share
-  IndexPageType page_type_ __attribute__((__unused__));
-  int size_ __attribute__((__unused__));
-  int max_size_ __attribute__((__unused__));
+  IndexPageType page_type_;
+  int size_;
+  int max_size_;
 };
 
 }  // namespace bustub
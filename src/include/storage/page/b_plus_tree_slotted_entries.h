@@ -0,0 +1,450 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_slotted_entries.h
+//
+// Identification: src/include/storage/page/b_plus_tree_slotted_entries.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * The entries of a B+ tree page that stores its keys as variable-length byte strings, see KeyAsBytes. A key is stored
+ * without the zero bytes that pad it at the end, and with head compression the bytes that every key of the page
+ * starts with are stored once, as the prefix. Slots grow from the front of the body, entries from the back:
+ *  ----------------------------------------------------------------------------------------------------------
+ * | PrefixSize (2) | HeapBegin (2) | PREFIX | SLOT(1) | ... | SLOT(n) | free space | ENTRY(n) | ... | ENTRY(1) |
+ *  ----------------------------------------------------------------------------------------------------------
+ * A slot holds the offset (2) and the suffix size (2) of its entry, an entry the value and then the key bytes after
+ * the prefix. The entries are packed, with no free space between them. The number of entries is kept in the page
+ * header, so it is passed to every method that needs it.
+ *
+ * The prefix of a page with two or more entries is the common prefix of its first and last key, which every key in
+ * between shares. Inserts shorten it, removes leave it as it is, and pages built from sorted entries get it exactly.
+ *
+ * @tparam BodySize the size of the page after its header
+ * @tparam HeadCompression whether to store the common prefix once; without it PrefixSize stays 0
+ */
+template <typename KeyType, typename ValueType, size_t BodySize, bool HeadCompression>
+class SlottedEntries {
+ public:
+  using Entry = std::pair<KeyType, ValueType>;
+
+  static constexpr size_t HEADER_SIZE = 4;
+  static constexpr size_t SLOT_SIZE = 4;
+  /** The size of a key, which GenericKey keeps in its bytes only. */
+  static constexpr size_t KEY_SIZE = sizeof(KeyType);
+  /** The most an entry takes up, its slot included. */
+  static constexpr size_t MAX_ENTRY_SIZE = SLOT_SIZE + sizeof(ValueType) + KEY_SIZE;
+  /** How many entries fit if all of their key bytes are in the prefix. */
+  static constexpr int MAX_ENTRIES = (BodySize - HEADER_SIZE) / (SLOT_SIZE + sizeof(ValueType));
+  /** A page that uses less is underfull. Splitting a page that is out of space leaves about this much in each half. */
+  static constexpr size_t MIN_USED_SIZE = (BodySize - MAX_ENTRY_SIZE) / 2;
+
+  static_assert(BodySize <= std::numeric_limits<uint16_t>::max(), "offsets do not fit into a slot");
+
+  // Only ever used in place, on the body of a page.
+  SlottedEntries() = delete;
+  SlottedEntries(const SlottedEntries &other) = delete;
+  ~SlottedEntries() = delete;
+
+  void Init() {
+    SetPrefixSize(0);
+    SetHeapBegin(BodySize);
+  }
+
+  /** @return the bytes of the body in use */
+  auto UsedSize(int size) const -> size_t {
+    return HEADER_SIZE + PrefixSize() + size * SLOT_SIZE + (BodySize - HeapBegin());
+  }
+
+  auto KeyAt(int index) const -> KeyType {
+    KeyType key;
+    memset(key.data_, 0, KEY_SIZE);
+    memcpy(key.data_, data_ + HEADER_SIZE, PrefixSize());
+    Slot slot = SlotAt(index);
+    memcpy(key.data_ + PrefixSize(), data_ + slot.offset_ + sizeof(ValueType), slot.size_);
+    return key;
+  }
+
+  auto ValueAt(int index) const -> ValueType {
+    ValueType value;
+    memcpy(&value, data_ + SlotAt(index).offset_, sizeof(ValueType));
+    return value;
+  }
+
+  void SetValueAt(int index, const ValueType &value) {
+    memcpy(data_ + SlotAt(index).offset_, &value, sizeof(ValueType));
+  }
+
+  /**
+   * @return the first index in [begin, size) whose key is not less than key, or with upper set the first whose key is
+   * greater; size if there is none
+   */
+  auto Search(const KeyType &key, int begin, int size, bool upper) const -> int {
+    // The prefix is compared once. A key outside of it sorts before or after every entry.
+    size_t prefix_size = PrefixSize();
+    int cmp = memcmp(key.data_, data_ + HEADER_SIZE, prefix_size);
+    if (cmp != 0) {
+      return cmp < 0 ? begin : size;
+    }
+    size_t length = Length(key);
+    int left = begin;
+    int right = size;
+    while (left < right) {
+      int mid = left + (right - left) / 2;
+      int entry_cmp = CompareSuffix(key, length, mid);
+      if (entry_cmp > 0 || (upper && entry_cmp == 0)) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    return left;
+  }
+
+  /** @return the bytes of the body in use once key is inserted */
+  auto UsedSizeWith(int size, const KeyType &key) const -> size_t {
+    size_t prefix_size = PrefixWith(size, key);
+    if (size > 0 && prefix_size == PrefixSize()) {
+      return UsedSize(size) + EntrySize(Length(key), prefix_size);
+    }
+    size_t used = HEADER_SIZE + prefix_size + EntrySize(Length(key), prefix_size);
+    for (int i = 0; i < size; i++) {
+      used += EntrySize(LengthAt(i), prefix_size);
+    }
+    return used;
+  }
+
+  /**
+   * @brief Insert an entry at index, shifting the later slots back. The entry has to fit, see UsedSizeWith(). An empty
+   * page is started over, whatever it held before its size was set to 0.
+   */
+  void InsertAt(int size, int index, const KeyType &key, const ValueType &value) {
+    size_t prefix_size = PrefixWith(size, key);
+    if (size == 0 || prefix_size != PrefixSize()) {
+      // Every stored key changes, so the page is written again. After the second key the prefix only gets shorter,
+      // so this happens at most once per byte of it.
+      Rebuild(Entries(size), prefix_size, key);
+    }
+    Place(size, index, key, value);
+  }
+
+  /** @brief Remove the entry at index and close the gap it leaves in the heap. The prefix stays as it is. */
+  void RemoveAt(int size, int index) {
+    Slot removed = SlotAt(index);
+    size_t entry_size = sizeof(ValueType) + removed.size_;
+    size_t heap_begin = HeapBegin();
+    memmove(data_ + heap_begin + entry_size, data_ + heap_begin, removed.offset_ - heap_begin);
+    for (int i = 0; i < size; i++) {
+      Slot slot = SlotAt(i);
+      if (slot.offset_ < removed.offset_) {
+        slot.offset_ += entry_size;
+        SetSlotAt(i, slot);
+      }
+    }
+    SetHeapBegin(heap_begin + entry_size);
+    char *slots = SlotsBegin();
+    memmove(slots + index * SLOT_SIZE, slots + (index + 1) * SLOT_SIZE, (size - index - 1) * SLOT_SIZE);
+  }
+
+  auto Entries(int size) const -> std::vector<Entry> {
+    std::vector<Entry> entries;
+    entries.reserve(size);
+    for (int i = 0; i < size; i++) {
+      entries.emplace_back(KeyAt(i), ValueAt(i));
+    }
+    return entries;
+  }
+
+  /** @brief Write the sorted entries to the page, replacing what it held, with the prefix Prefix() gives them. */
+  void Rebuild(const std::vector<Entry> &entries) {
+    if (entries.empty()) {
+      Init();
+      return;
+    }
+    Rebuild(entries, Prefix(entries.data(), entries.size()), entries[0].first);
+  }
+
+  /** @return the length of key without the zero bytes at its end */
+  static auto Length(const KeyType &key) -> size_t {
+    size_t length = KEY_SIZE;
+    while (length > 0 && key.data_[length - 1] == 0) {
+      length--;
+    }
+    return length;
+  }
+
+  static auto CommonPrefix(const KeyType &lhs, const KeyType &rhs) -> size_t {
+    size_t length = 0;
+    while (length < KEY_SIZE && lhs.data_[length] == rhs.data_[length]) {
+      length++;
+    }
+    return length;
+  }
+
+  /** @return the prefix of a page built from the sorted entries */
+  static auto Prefix(const Entry *entries, size_t count) -> size_t {
+    if (!HeadCompression || count == 0) {
+      return 0;
+    }
+    return count == 1 ? Length(entries[0].first) : CommonPrefix(entries[0].first, entries[count - 1].first);
+  }
+
+  /** @return the bytes of the body a page built from the sorted entries uses */
+  static auto Size(const Entry *entries, size_t count) -> size_t {
+    size_t prefix_size = Prefix(entries, count);
+    size_t used = HEADER_SIZE + prefix_size;
+    for (size_t i = 0; i < count; i++) {
+      used += EntrySize(Length(entries[i].first), prefix_size);
+    }
+    return used;
+  }
+
+  /**
+   * @return the number of the sorted entries to put into the left page when splitting them in two: the split that
+   * leaves the sizes of the pages closest, among those where both pages fit and get between min_count and max_count
+   * entries
+   */
+  static auto SplitPoint(const std::vector<Entry> &entries, int min_count, int max_count) -> int {
+    int count = static_cast<int>(entries.size());
+    // The sizes of the pages made of the first and of the last entries, for every split.
+    std::vector<size_t> left_sizes(count + 1);
+    std::vector<size_t> right_sizes(count + 1);
+    RangeSize left;
+    for (int i = 0; i < count; i++) {
+      left.Add(entries[i].first);
+      left_sizes[i + 1] = left.Get();
+    }
+    RangeSize right;
+    for (int i = count; i > 0; i--) {
+      right.Add(entries[i - 1].first);
+      right_sizes[i - 1] = right.Get();
+    }
+    int best = count / 2;
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    for (int split = std::max(min_count, count - max_count); split <= std::min(max_count, count - min_count); split++) {
+      if (left_sizes[split] > BodySize || right_sizes[split] > BodySize) {
+        continue;
+      }
+      size_t gap = std::max(left_sizes[split], right_sizes[split]) - std::min(left_sizes[split], right_sizes[split]);
+      if (gap < best_gap) {
+        best = split;
+        best_gap = gap;
+      }
+    }
+    BUSTUB_ASSERT(best_gap != std::numeric_limits<size_t>::max(), "no split fits both pages");
+    return best;
+  }
+
+  /**
+   * @return the entry counts of the pages the sorted entries are bulk loaded into. Each page is filled to fill_factor
+   * of the body but at least to half of it, and the last one is balanced with the one before if it would be underfull.
+   */
+  static auto BulkLoadSizes(const std::vector<Entry> &entries, int min_count, int max_count, double fill_factor)
+      -> std::vector<int> {
+    size_t target = std::clamp(static_cast<size_t>(fill_factor * BodySize), BodySize / 2, BodySize);
+    int count = static_cast<int>(entries.size());
+    std::vector<int> sizes;
+    int begin = 0;
+    while (begin < count) {
+      RangeSize page;
+      int end = begin;
+      while (end < count && end - begin < max_count && (end - begin < min_count || page.Get() < target) &&
+             page.With(entries[end].first) <= BodySize) {
+        page.Add(entries[end].first);
+        end++;
+      }
+      sizes.push_back(end - begin);
+      begin = end;
+    }
+    if (sizes.size() < 2) {
+      return sizes;
+    }
+    int last_begin = count - sizes.back();
+    if (sizes.back() >= min_count && Size(entries.data() + last_begin, sizes.back()) >= MIN_USED_SIZE) {
+      return sizes;
+    }
+    sizes.pop_back();
+    int pair_begin = last_begin - sizes.back();
+    int pair_count = count - pair_begin;
+    if (pair_count <= max_count && Size(entries.data() + pair_begin, pair_count) <= BodySize) {
+      sizes.back() = pair_count;
+      return sizes;
+    }
+    std::vector<Entry> pair(entries.begin() + pair_begin, entries.end());
+    sizes.back() = SplitPoint(pair, min_count, max_count);
+    sizes.push_back(pair_count - sizes.back());
+    return sizes;
+  }
+
+ private:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t size_;
+  };
+
+  static auto EntrySize(size_t length, size_t prefix_size) -> size_t {
+    return SLOT_SIZE + sizeof(ValueType) + std::max(length, prefix_size) - prefix_size;
+  }
+
+  /** The size Size() gives a range of sorted entries, kept up to date while entries are added at one end of it. */
+  class RangeSize {
+   public:
+    /** @return the size once key is added */
+    auto With(const KeyType &key) const -> size_t {
+      size_t prefix_size = PrefixWith(key);
+      size_t used = HEADER_SIZE + prefix_size + EntrySize(Length(key), prefix_size);
+      if (prefix_size == prefix_size_) {
+        return used + sum_;
+      }
+      for (size_t length : lengths_) {
+        used += EntrySize(length, prefix_size);
+      }
+      return used;
+    }
+
+    void Add(const KeyType &key) {
+      size_t prefix_size = PrefixWith(key);
+      if (lengths_.empty()) {
+        first_ = key;
+      }
+      if (prefix_size != prefix_size_) {
+        sum_ = 0;
+        for (size_t length : lengths_) {
+          sum_ += EntrySize(length, prefix_size);
+        }
+        prefix_size_ = prefix_size;
+      }
+      lengths_.push_back(Length(key));
+      sum_ += EntrySize(lengths_.back(), prefix_size_);
+    }
+
+    auto Get() const -> size_t { return HEADER_SIZE + prefix_size_ + sum_; }
+
+   private:
+    /** The range is sorted, so its prefix is the common prefix of the entry it grows from and the one added last. */
+    auto PrefixWith(const KeyType &key) const -> size_t {
+      if (!HeadCompression) {
+        return 0;
+      }
+      return lengths_.empty() ? Length(key) : CommonPrefix(first_, key);
+    }
+
+    KeyType first_;
+    std::vector<size_t> lengths_;
+    size_t prefix_size_{0};
+    size_t sum_{0};
+  };
+
+  auto PrefixSize() const -> size_t { return GetField(0); }
+  void SetPrefixSize(size_t prefix_size) { SetField(0, prefix_size); }
+  auto HeapBegin() const -> size_t { return GetField(2); }
+  void SetHeapBegin(size_t heap_begin) { SetField(2, heap_begin); }
+
+  auto GetField(size_t offset) const -> size_t {
+    uint16_t field;
+    memcpy(&field, data_ + offset, sizeof(field));
+    return field;
+  }
+  void SetField(size_t offset, size_t value) {
+    auto field = static_cast<uint16_t>(value);
+    memcpy(data_ + offset, &field, sizeof(field));
+  }
+
+  auto SlotsBegin() -> char * { return data_ + HEADER_SIZE + PrefixSize(); }
+  auto SlotAt(int index) const -> Slot {
+    Slot slot;
+    memcpy(&slot, data_ + HEADER_SIZE + PrefixSize() + index * SLOT_SIZE, SLOT_SIZE);
+    return slot;
+  }
+  void SetSlotAt(int index, Slot slot) { memcpy(SlotsBegin() + index * SLOT_SIZE, &slot, SLOT_SIZE); }
+
+  /** @return the length of the key at index; its suffix ends with a byte that is not zero unless it is empty */
+  auto LengthAt(int index) const -> size_t {
+    Slot slot = SlotAt(index);
+    if (slot.size_ > 0) {
+      return PrefixSize() + slot.size_;
+    }
+    size_t length = PrefixSize();
+    while (length > 0 && data_[HEADER_SIZE + length - 1] == 0) {
+      length--;
+    }
+    return length;
+  }
+
+  /** @return the prefix once key is inserted, the common prefix of key and the keys of the page */
+  auto PrefixWith(int size, const KeyType &key) const -> size_t {
+    if (!HeadCompression) {
+      return 0;
+    }
+    if (size == 0) {
+      return Length(key);
+    }
+    if (size == 1) {
+      // The prefix of a single key is all of it, so it may grow when the second key is longer.
+      return CommonPrefix(key, KeyAt(0));
+    }
+    size_t prefix_size = PrefixSize();
+    size_t length = 0;
+    while (length < prefix_size && key.data_[length] == data_[HEADER_SIZE + length]) {
+      length++;
+    }
+    return length;
+  }
+
+  /** Compares key, whose bytes from the prefix on are those of the entry, with the key at index. */
+  auto CompareSuffix(const KeyType &key, size_t length, int index) const -> int {
+    Slot slot = SlotAt(index);
+    size_t prefix_size = PrefixSize();
+    int cmp = memcmp(key.data_ + prefix_size, data_ + slot.offset_ + sizeof(ValueType), slot.size_);
+    if (cmp != 0) {
+      return cmp;
+    }
+    // The entry continues with zeros, so key is greater exactly if it has any other bytes left.
+    return static_cast<int>(length > prefix_size + slot.size_);
+  }
+
+  /** Writes the entries with a prefix of prefix_size, whose bytes are taken from key. */
+  void Rebuild(const std::vector<Entry> &entries, size_t prefix_size, const KeyType &key) {
+    SetHeapBegin(BodySize);
+    SetPrefixSize(prefix_size);
+    memcpy(data_ + HEADER_SIZE, key.data_, prefix_size);
+    for (size_t i = 0; i < entries.size(); i++) {
+      Place(i, i, entries[i].first, entries[i].second);
+    }
+  }
+
+  /** Stores an entry at index under the current prefix, which key has to start with. */
+  void Place(int size, int index, const KeyType &key, const ValueType &value) {
+    size_t prefix_size = PrefixSize();
+    size_t suffix_size = std::max(Length(key), prefix_size) - prefix_size;
+    size_t entry_size = sizeof(ValueType) + suffix_size;
+    BUSTUB_ASSERT(UsedSize(size) + SLOT_SIZE + entry_size <= BodySize, "page is out of space");
+    size_t offset = HeapBegin() - entry_size;
+    memcpy(data_ + offset, &value, sizeof(ValueType));
+    memcpy(data_ + offset + sizeof(ValueType), key.data_ + prefix_size, suffix_size);
+    SetHeapBegin(offset);
+    char *slots = SlotsBegin();
+    memmove(slots + (index + 1) * SLOT_SIZE, slots + index * SLOT_SIZE, (size - index) * SLOT_SIZE);
+    SetSlotAt(index, {static_cast<uint16_t>(offset), static_cast<uint16_t>(suffix_size)});
+  }
+
+  char data_[0];
+};
+
+}  // namespace bustub
@@ -64,11 +64,24 @@ class HashTableBlockPage {
    * @param bucket_ind index to write the key and value to
    * @param key key to insert
    * @param value value to insert
+   * @param fingerprint fingerprint of the key's hash, see Fingerprint()
    * @return If the value is inserted successfully, it returns true. If the
    * index is marked as occupied before the key and value can be inserted,
    * Insert returns false.
    */
-  auto Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) -> bool;
+  auto Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value, uint8_t fingerprint) -> bool;
+
+  /**
+   * Gets the fingerprint of the key at an index in the block. A probe only
+   * compares the keys whose fingerprint matches the one it is looking for.
+   *
+   * @param bucket_ind the index in the block to get the fingerprint at
+   * @return fingerprint at index bucket_ind of the block
+   */
+  auto FingerprintAt(slot_offset_t bucket_ind) const -> uint8_t;
+
+  /** @return the fingerprint of a key hash: its top byte, as the low bits pick the slot */
+  static auto Fingerprint(uint64_t hash) -> uint8_t { return hash >> 56; }
 
   /**
    * Removes a key and value at index.
@@ -143,6 +156,8 @@ class HashTableBlockPage {
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  // One byte of the hash of each key, written before the slot becomes readable.
+  uint8_t fingerprints_[BLOCK_ARRAY_SIZE];
   // Flexible array member for page data.
   MappingType array_[1];
 };
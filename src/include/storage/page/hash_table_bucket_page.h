@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -33,6 +34,10 @@ namespace bustub {
  *  The above format omits the space required for the occupied_ and
  *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
  *
+ *  Every slot also keeps one byte of its key's hash. Lookups compare these
+ *  fingerprints 16 slots at a time (with SSE2 where available) and only
+ *  call the comparator on the slots whose fingerprint matches.
+ *
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
@@ -43,9 +48,10 @@ class HashTableBucketPage {
   /**
    * Scan the bucket and collect values that have the matching key
    *
+   * @param hash the 32-bit hash of key
    * @return true if at least one key matched
    */
-  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool;
+  auto GetValue(KeyType key, uint32_t hash, KeyComparator cmp, std::vector<ValueType> *result) const -> bool;
 
   /**
    * Attempts to insert a key and value in the bucket.  Uses the occupied_
@@ -53,16 +59,18 @@ class HashTableBucketPage {
    *
    * @param key key to insert
    * @param value value to insert
+   * @param hash the 32-bit hash of key
    * @return true if inserted, false if duplicate KV pair or bucket is full
    */
-  auto Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool;
+  auto Insert(KeyType key, ValueType value, uint32_t hash, KeyComparator cmp) -> bool;
 
   /**
    * Removes a key and value.
    *
+   * @param hash the 32-bit hash of key
    * @return true if removed, false if not found
    */
-  auto Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool;
+  auto Remove(KeyType key, ValueType value, uint32_t hash, KeyComparator cmp) -> bool;
 
   /**
    * Gets the key at an index in the bucket.
@@ -120,28 +128,49 @@ class HashTableBucketPage {
   /**
    * @return the number of readable elements, i.e. current size
    */
-  auto NumReadable() -> uint32_t;
+  auto NumReadable() const -> uint32_t;
 
   /**
    * @return whether the bucket is full
    */
-  auto IsFull() -> bool;
+  auto IsFull() const -> bool;
 
   /**
    * @return whether the bucket is empty
    */
-  auto IsEmpty() -> bool;
+  auto IsEmpty() const -> bool;
 
   /**
    * Prints the bucket's occupancy information
    */
   void PrintBucket();
 
+  /**
+   * The fingerprint kept for a key: bits 12-19 of its hash. Extendible hashing picks the directory by the high bits
+   * of the hash and the bucket by the low ones, which are therefore mostly the same within a bucket.
+   *
+   * @param hash the 32-bit hash of a key
+   * @return the fingerprint of the key
+   */
+  static auto Fingerprint(uint32_t hash) -> uint8_t { return static_cast<uint8_t>(hash >> 12); }
+
  private:
+  /** @return a mask of the slots of group whose fingerprint is fingerprint */
+  auto MatchFingerprint(uint32_t group, uint8_t fingerprint) const -> uint32_t;
+
+  /** @return the 16 bits of bitmap that belong to group */
+  static auto GroupBits(const char *bitmap, uint32_t group) -> uint32_t;
+
+  /** @return the slot of the first readable pair that has key, and value if given, starting at slot start */
+  auto FindSlot(uint32_t start, const KeyType &key, const ValueType *value, uint8_t fingerprint,
+                KeyComparator cmp) const -> std::optional<uint32_t>;
+
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
-  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  char occupied_[BUCKET_SLOT_GROUPS * 2];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  char readable_[BUCKET_SLOT_GROUPS * 2];
+  // One byte of each slot's hash.
+  uint8_t fingerprints_[BUCKET_SLOT_GROUPS * 16];
   // Flexible array member for page data.
   MappingType array_[1];
 };
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_header_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_header_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Header Page for extendible hash table. It is the first of three levels, header -> directory -> bucket.
+ *
+ * Header format (size in byte):
+ * ---------------------------------------------------
+ * | DirectoryPageIds(2048) | MaxDepth(4) | Free(2044)
+ * ---------------------------------------------------
+ */
+class HashTableDirectoryHeaderPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableDirectoryHeaderPage() = delete;
+
+  /**
+   * After creating a new header page from the buffer pool, must call Init to set default values
+   *
+   * @param max_depth number of high hash bits that pick a directory, at most log2(DIRECTORY_HEADER_ARRAY_SIZE)
+   */
+  void Init(uint32_t max_depth);
+
+  /**
+   * Maps a hash to the index of the directory that holds it: its max_depth most significant bits
+   *
+   * @param hash the 32-bit hash of a key
+   * @return the directory index
+   */
+  auto HashToDirectoryIndex(uint32_t hash) const -> uint32_t;
+
+  /**
+   * @param directory_idx the index of a directory
+   * @return the page id of the directory, INVALID_PAGE_ID if none has been created yet
+   */
+  auto GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t;
+
+  /**
+   * @param directory_idx the index of a directory
+   * @param directory_page_id the page id of the directory
+   */
+  void SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id);
+
+  /**
+   * @return the number of directories the header can point to
+   */
+  auto MaxSize() const -> uint32_t;
+
+  /**
+   * @return the number of hash bits that pick a directory
+   */
+  auto GetMaxDepth() const -> uint32_t;
+
+ private:
+  page_id_t directory_page_ids_[DIRECTORY_HEADER_ARRAY_SIZE];
+  uint32_t max_depth_;
+};
+
+}  // namespace bustub
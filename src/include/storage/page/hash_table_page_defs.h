@@ -24,9 +24,10 @@
  * approximate calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each
  * key/value pair, we need two additional bits for occupied_ and readable_. 4 * BUSTUB_PAGE_SIZE / (4 * sizeof
  * (MappingType) + 1) = BUSTUB_PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required
- * to maintain the occupied and readable flags for a key value pair.
+ * to maintain the occupied and readable flags for a key value pair. Each pair also has a one byte fingerprint of its
+ * hash, hence the + 4 below, and the first 32 bytes of the page are set aside for rounding and alignment padding.
  */
-#define BLOCK_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BLOCK_ARRAY_SIZE (4 * (BUSTUB_PAGE_SIZE - 32) / (4 * sizeof(MappingType) + 4 + 1))
 
 /**
  * Extendible Hashing Definitions
@@ -38,13 +39,25 @@
  * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
  * of search, insertion, removal, and helper methods.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_ARRAY_SIZE (4 * (BUSTUB_PAGE_SIZE - 32) / (4 * sizeof(MappingType) + 4 + 1))
+
+/**
+ * BUCKET_SLOT_GROUPS is the number of 16-slot groups whose fingerprints a bucket page compares at once. The
+ * fingerprint array and the occupied_ and readable_ bitmaps are padded to whole groups.
+ */
+#define BUCKET_SLOT_GROUPS ((BUCKET_ARRAY_SIZE - 1) / 16 + 1)
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
  * This is 512 because the directory array must grow in powers of 2, and 1024 page_ids leaves zero room for
  * storage of the other member variables: page_id_, lsn_, global_depth_, and the array local_depths_.
- * Extending the directory implementation to span multiple pages would be a meaningful improvement to the
- * implementation.
+ * A table spans up to DIRECTORY_HEADER_ARRAY_SIZE directories instead, see below.
  */
 #define DIRECTORY_ARRAY_SIZE 512
+
+/**
+ * DIRECTORY_HEADER_ARRAY_SIZE is the number of directory page_ids that fit in the header page of an extendible hash
+ * index. The header picks a directory by the high bits of the hash, the directory a bucket by its low bits, so each
+ * directory grows and shrinks on its own. Like the directory array it is a power of 2, leaving room for max_depth_.
+ */
+#define DIRECTORY_HEADER_ARRAY_SIZE 512
@@ -15,6 +15,7 @@
 #include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
@@ -63,9 +64,10 @@ class TableHeap {
   /**
    * Read a tuple from the table.
    * @param rid rid of the tuple to read
+   * @param access_type type of access to the page of the tuple
    * @return the meta and tuple
    */
-  auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
+  auto GetTuple(RID rid, AccessType access_type = AccessType::Unknown) -> std::pair<TupleMeta, Tuple>;
 
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` insead
@@ -93,11 +95,24 @@ class TableHeap {
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
  private:
+  /**
+   * @return the ids of the pages at positions [begin, end) of the page chain, fewer if the heap has less pages
+   */
+  auto GetPageIds(size_t begin, size_t end) -> std::vector<page_id_t>;
+
+  /**
+   * @return the position of page_id in the page chain
+   */
+  auto GetPageIndex(page_id_t page_id) -> size_t;
+
   BufferPoolManager *bpm_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
 
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+  /* the ids of all pages in chain order, so that scans can read ahead without following the chain. protected by
+   * latch_ */
+  std::vector<page_id_t> page_ids_;
 };
 
 }  // namespace bustub
@@ -13,9 +13,11 @@
 #pragma once
 
 #include <cassert>
+#include <limits>
 #include <memory>
 #include <utility>
 
+#include "buffer/buffer_access_strategy.h"
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
@@ -27,6 +29,10 @@ class TableHeap;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
+ *
+ * Pages are fetched with AccessType::Scan into the iterator's own BufferAccessStrategy ring, and the iterator keeps up
+ * to READ_AHEAD_PAGES of the pages after the current one prefetched, so that the scan mostly finds its next page
+ * already in the buffer pool. The window is capped so that it fits into the ring together with the current page.
  */
 class TableIterator {
   friend class Cursor;
@@ -48,13 +54,27 @@ class TableIterator {
   auto operator++() -> TableIterator &;
 
  private:
+  /** @brief Prefetch the pages of the read-ahead window that have not been prefetched yet. */
+  void ReadAhead();
+
   TableHeap *table_heap_;
   RID rid_;
+  /** The ring the pages of the scan are loaded into; on the heap, so that moving the iterator does not move it. */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
 
   // When creating table iterator, we will record the maximum RID that we should scan.
   // Otherwise we will have dead loops when updating while scanning. (In project 4, update should be implemented as
   // deletion + insertion.)
   RID stop_at_rid_;
+  /** Position of the page of stop_at_rid_ in the page chain, the maximum if there is no stop. */
+  size_t stop_page_index_{std::numeric_limits<size_t>::max()};
+
+  /** Position of the page of rid_ in the page chain of the table heap. */
+  size_t page_index_{0};
+  /** The pages of the chain before this position have been prefetched (or scanned) already. */
+  size_t read_ahead_end_{0};
+  /** Number of pages to keep prefetched ahead of the current one. */
+  size_t read_ahead_pages_{0};
 };
 
 }  // namespace bustub
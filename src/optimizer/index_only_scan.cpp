@@ -0,0 +1,127 @@
+#include <memory>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** The columns a plan needs from its child, nullopt if it may need all of them. */
+using UsedColumns = std::optional<std::set<uint32_t>>;
+
+void CollectColumns(const AbstractExpressionRef &expr, std::set<uint32_t> *columns) {
+  if (const auto *column_value = dynamic_cast<const ColumnValueExpression *>(expr.get()); column_value != nullptr) {
+    columns->insert(column_value->GetColIdx());
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+void CollectColumns(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys,
+                    std::set<uint32_t> *columns) {
+  for (const auto &[order_type, expr] : order_bys) {
+    CollectColumns(expr, columns);
+  }
+}
+
+/** The columns the only child of plan has to produce, given the columns used of plan's own output. */
+auto ChildUsedColumns(const AbstractPlanNode &plan, const UsedColumns &used) -> UsedColumns {
+  std::set<uint32_t> columns;
+  switch (plan.GetType()) {
+    case PlanType::Projection:
+      for (const auto &expr : dynamic_cast<const ProjectionPlanNode &>(plan).GetExpressions()) {
+        CollectColumns(expr, &columns);
+      }
+      return columns;
+    case PlanType::Aggregation: {
+      const auto &aggregation = dynamic_cast<const AggregationPlanNode &>(plan);
+      for (const auto &expr : aggregation.GetGroupBys()) {
+        CollectColumns(expr, &columns);
+      }
+      for (const auto &expr : aggregation.GetAggregates()) {
+        CollectColumns(expr, &columns);
+      }
+      return columns;
+    }
+    // These pass their child's tuples through, so they need what their parent needs, and their own columns.
+    case PlanType::Limit:
+      return used;
+    case PlanType::Filter:
+      if (!used.has_value()) {
+        return std::nullopt;
+      }
+      columns = *used;
+      CollectColumns(dynamic_cast<const FilterPlanNode &>(plan).GetPredicate(), &columns);
+      return columns;
+    case PlanType::Sort:
+      if (!used.has_value()) {
+        return std::nullopt;
+      }
+      columns = *used;
+      CollectColumns(dynamic_cast<const SortPlanNode &>(plan).GetOrderBy(), &columns);
+      return columns;
+    case PlanType::TopN:
+      if (!used.has_value()) {
+        return std::nullopt;
+      }
+      columns = *used;
+      CollectColumns(dynamic_cast<const TopNPlanNode &>(plan).GetOrderBy(), &columns);
+      return columns;
+    default:
+      return std::nullopt;
+  }
+}
+
+auto RewriteIndexOnlyScan(const Catalog &catalog, const AbstractPlanNodeRef &plan, const UsedColumns &used)
+    -> AbstractPlanNodeRef {
+  if (plan->GetType() == PlanType::IndexScan) {
+    const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*plan);
+    if (!used.has_value() || index_scan.index_only_) {
+      return plan;
+    }
+    std::set<uint32_t> needed = *used;
+    if (index_scan.filter_predicate_ != nullptr) {
+      CollectColumns(index_scan.filter_predicate_, &needed);
+    }
+    const auto &key_attrs = catalog.GetIndex(index_scan.GetIndexOid())->index_->GetKeyAttrs();
+    std::set<uint32_t> covered(key_attrs.begin(), key_attrs.end());
+    for (auto column : needed) {
+      if (covered.count(column) == 0) {
+        return plan;
+      }
+    }
+    auto index_only_scan = std::make_shared<IndexScanPlanNode>(index_scan);
+    index_only_scan->index_only_ = true;
+    return index_only_scan;
+  }
+
+  std::vector<AbstractPlanNodeRef> children;
+  UsedColumns child_used = plan->GetChildren().size() == 1 ? ChildUsedColumns(*plan, used) : std::nullopt;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(RewriteIndexOnlyScan(catalog, child, child_used));
+  }
+  return plan->CloneWithChildren(std::move(children));
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  // The columns the root produces are all needed.
+  return RewriteIndexOnlyScan(catalog_, plan, std::nullopt);
+}
+
+}  // namespace bustub
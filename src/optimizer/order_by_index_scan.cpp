@@ -21,6 +21,65 @@
 
 namespace bustub {
 
+namespace {
+
+/**
+ * Matches an ORDER BY on plain columns, all ascending or all descending, against the indexes of the table scanned
+ * by child_plan and returns an index scan that produces the same order, or nullptr if there is none.
+ */
+auto MatchOrderByIndexScan(const Catalog &catalog, const SchemaRef &output_schema,
+                           const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys,
+                           const AbstractPlanNodeRef &child_plan) -> std::shared_ptr<IndexScanPlanNode> {
+  if (child_plan->GetType() != PlanType::SeqScan || order_bys.empty()) {
+    return nullptr;
+  }
+
+  std::vector<uint32_t> order_by_column_ids;
+  bool reverse = order_bys[0].first == OrderByType::DESC;
+  for (const auto &[order_type, expr] : order_bys) {
+    // Order types are all asc or default, or all desc
+    if ((order_type == OrderByType::DESC) != reverse || order_type == OrderByType::INVALID) {
+      return nullptr;
+    }
+
+    // Order expression is a column value expression
+    const auto *column_value_expr = dynamic_cast<ColumnValueExpression *>(expr.get());
+    if (column_value_expr == nullptr) {
+      return nullptr;
+    }
+
+    order_by_column_ids.push_back(column_value_expr->GetColIdx());
+  }
+
+  const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+  const auto *table_info = catalog.GetTable(seq_scan.GetTableOid());
+  const auto indices = catalog.GetTableIndexes(table_info->name_);
+
+  for (const auto *index : indices) {
+    const auto &columns = index->key_schema_.GetColumns();
+    // check index search key columns == order by columns; included columns come after them
+    bool valid = true;
+    size_t search_column_count = index->index_->GetMetadata()->GetSearchColumnCount();
+    if (search_column_count == order_by_column_ids.size()) {
+      for (size_t i = 0; i < search_column_count; i++) {
+        if (columns[i].GetName() != table_info->schema_.GetColumn(order_by_column_ids[i]).GetName()) {
+          valid = false;
+          break;
+        }
+      }
+      if (valid) {
+        auto index_scan =
+            std::make_shared<IndexScanPlanNode>(output_schema, index->index_oid_, seq_scan.filter_predicate_);
+        index_scan->reverse_ = reverse;
+        return index_scan;
+      }
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
 auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
   std::vector<AbstractPlanNodeRef> children;
   for (const auto &child : plan->GetChildren()) {
@@ -30,49 +89,12 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
 
   if (optimized_plan->GetType() == PlanType::Sort) {
     const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*optimized_plan);
-    const auto &order_bys = sort_plan.GetOrderBy();
-
-    std::vector<uint32_t> order_by_column_ids;
-    for (const auto &[order_type, expr] : order_bys) {
-      // Order type is asc or default
-      if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
-        return optimized_plan;
-      }
-
-      // Order expression is a column value expression
-      const auto *column_value_expr = dynamic_cast<ColumnValueExpression *>(expr.get());
-      if (column_value_expr == nullptr) {
-        return optimized_plan;
-      }
-
-      order_by_column_ids.push_back(column_value_expr->GetColIdx());
-    }
-
     // Has exactly one child
     BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "Sort with multiple children?? Impossible!");
-    const auto &child_plan = optimized_plan->children_[0];
-
-    if (child_plan->GetType() == PlanType::SeqScan) {
-      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
-      const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
-      const auto indices = catalog_.GetTableIndexes(table_info->name_);
-
-      for (const auto *index : indices) {
-        const auto &columns = index->key_schema_.GetColumns();
-        // check index key schema == order by columns
-        bool valid = true;
-        if (columns.size() == order_by_column_ids.size()) {
-          for (size_t i = 0; i < columns.size(); i++) {
-            if (columns[i].GetName() != table_info->schema_.GetColumn(order_by_column_ids[i]).GetName()) {
-              valid = false;
-              break;
-            }
-          }
-          if (valid) {
-            return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
-          }
-        }
-      }
+    auto index_scan = MatchOrderByIndexScan(catalog_, optimized_plan->output_schema_, sort_plan.GetOrderBy(),
+                                            optimized_plan->children_[0]);
+    if (index_scan != nullptr) {
+      return index_scan;
     }
   }
 
@@ -0,0 +1,157 @@
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Bounds on one column collected from the conjuncts of a predicate. */
+struct ColumnBounds {
+  std::optional<Value> lower_;
+  bool lower_inclusive_{true};
+  std::optional<Value> upper_;
+  bool upper_inclusive_{true};
+
+  void TightenLower(const Value &value, bool inclusive) {
+    if (!lower_.has_value() || value.CompareGreaterThan(*lower_) == CmpBool::CmpTrue ||
+        (value.CompareEquals(*lower_) == CmpBool::CmpTrue && !inclusive)) {
+      lower_ = value;
+      lower_inclusive_ = inclusive;
+    }
+  }
+
+  void TightenUpper(const Value &value, bool inclusive) {
+    if (!upper_.has_value() || value.CompareLessThan(*upper_) == CmpBool::CmpTrue ||
+        (value.CompareEquals(*upper_) == CmpBool::CmpTrue && !inclusive)) {
+      upper_ = value;
+      upper_inclusive_ = inclusive;
+    }
+  }
+};
+
+/** Mirrors a comparison, for `constant op column` written as `column op' constant`. */
+auto FlipComparison(ComparisonType comp_type) -> ComparisonType {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+/** Collects the bounds that the AND-ed comparisons of expr put on column col_idx of the scanned table. */
+void CollectBounds(const AbstractExpressionRef &expr, uint32_t col_idx, TypeId col_type, ColumnBounds *bounds) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get()); logic != nullptr) {
+    if (logic->logic_type_ == LogicType::And) {
+      CollectBounds(logic->children_[0], col_idx, col_type, bounds);
+      CollectBounds(logic->children_[1], col_idx, col_type, bounds);
+    }
+    return;
+  }
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comparison == nullptr) {
+    return;
+  }
+  auto comp_type = comparison->comp_type_;
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->children_[0].get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->children_[1].get());
+  if (column == nullptr || constant == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->children_[1].get());
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->children_[0].get());
+    comp_type = FlipComparison(comp_type);
+  }
+  // The bound is encoded as an index key of the column's type, so the constant has to have that type exactly.
+  if (column == nullptr || constant == nullptr || column->GetTupleIdx() != 0 || column->GetColIdx() != col_idx ||
+      constant->val_.GetTypeId() != col_type || constant->val_.IsNull()) {
+    return;
+  }
+  const Value &value = constant->val_;
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      bounds->TightenLower(value, true);
+      bounds->TightenUpper(value, true);
+      break;
+    case ComparisonType::LessThan:
+      bounds->TightenUpper(value, false);
+      break;
+    case ComparisonType::LessThanOrEqual:
+      bounds->TightenUpper(value, true);
+      break;
+    case ComparisonType::GreaterThan:
+      bounds->TightenLower(value, false);
+      break;
+    case ComparisonType::GreaterThanOrEqual:
+      bounds->TightenLower(value, true);
+      break;
+    case ComparisonType::NotEqual:
+      break;
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // Either a filter right above a plain sequential scan, or a scan the filter was already merged into.
+  const SeqScanPlanNode *seq_scan = nullptr;
+  AbstractExpressionRef predicate;
+  if (optimized_plan->GetType() == PlanType::Filter) {
+    const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+    BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "Filter with multiple children?? Impossible!");
+    if (optimized_plan->children_[0]->GetType() == PlanType::SeqScan) {
+      seq_scan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan->children_[0].get());
+      predicate = seq_scan->filter_predicate_ == nullptr ? filter_plan.GetPredicate() : nullptr;
+    }
+  } else if (optimized_plan->GetType() == PlanType::SeqScan) {
+    seq_scan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan.get());
+    predicate = seq_scan->filter_predicate_;
+  }
+  if (predicate == nullptr) {
+    return optimized_plan;
+  }
+
+  const auto *table_info = catalog_.GetTable(seq_scan->GetTableOid());
+  for (const auto *index_info : catalog_.GetTableIndexes(table_info->name_)) {
+    uint32_t col_idx = index_info->index_->GetKeyAttrs()[0];
+    ColumnBounds bounds;
+    CollectBounds(predicate, col_idx, table_info->schema_.GetColumn(col_idx).GetType(), &bounds);
+    if (!bounds.lower_.has_value() && !bounds.upper_.has_value()) {
+      continue;
+    }
+    // The whole predicate stays on the scan; the bounds only narrow down the keys it is evaluated on.
+    auto index_scan =
+        std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index_info->index_oid_, predicate);
+    index_scan->lower_bound_ = bounds.lower_;
+    index_scan->lower_inclusive_ = bounds.lower_inclusive_;
+    index_scan->upper_bound_ = bounds.upper_;
+    index_scan->upper_inclusive_ = bounds.upper_inclusive_;
+    return index_scan;
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager.cpp
+//
+// Identification: src/storage/disk/async_disk_manager.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_disk_manager.h"
+
+#include <exception>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+AsyncDiskManager::AsyncDiskManager(DiskManager *disk_manager, size_t num_threads) : disk_manager_(disk_manager) {
+  BUSTUB_ASSERT(num_threads > 0, "at least one I/O thread is needed");
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back(&AsyncDiskManager::ServeRequests, this);
+  }
+}
+
+AsyncDiskManager::~AsyncDiskManager() {
+  {
+    std::scoped_lock lock(latch_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void AsyncDiskManager::Submit(DiskRequest request) {
+  {
+    std::scoped_lock lock(latch_);
+    BUSTUB_ASSERT(!shutdown_, "cannot submit to a stopped AsyncDiskManager");
+    queue_.emplace_back(std::move(request));
+  }
+  cv_.notify_one();
+}
+
+auto AsyncDiskManager::SubmitRead(page_id_t page_id, char *data) -> std::future<bool> {
+  std::promise<bool> promise;
+  auto future = promise.get_future();
+  Submit({false, data, page_id, std::move(promise), nullptr});
+  return future;
+}
+
+auto AsyncDiskManager::SubmitWrite(page_id_t page_id, const char *data) -> std::future<bool> {
+  std::promise<bool> promise;
+  auto future = promise.get_future();
+  // the data of a write is only ever read
+  Submit({true, const_cast<char *>(data), page_id, std::move(promise), nullptr});
+  return future;
+}
+
+void AsyncDiskManager::ServeRequests() {
+  std::unique_lock lock(latch_);
+  while (true) {
+    cv_.wait(lock, [this] { return shutdown_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      // shutting down, and everything submitted has been served
+      return;
+    }
+    DiskRequest request = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+
+    std::exception_ptr error;
+    try {
+      if (request.is_write_) {
+        disk_manager_->WritePage(request.page_id_, request.data_);
+      } else {
+        disk_manager_->ReadPage(request.page_id_, request.data_);
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    if (request.on_complete_) {
+      request.on_complete_(error == nullptr);
+    }
+    if (error == nullptr) {
+      request.callback_.set_value(true);
+    } else {
+      request.callback_.set_exception(error);
+    }
+
+    lock.lock();
+  }
+}
+
+}  // namespace bustub
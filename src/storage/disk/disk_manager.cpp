@@ -10,8 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
@@ -20,6 +25,7 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
@@ -30,7 +36,7 @@ static char *buffer_used;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io) : file_name_(db_file) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -50,26 +56,55 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
   }
 
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
+#ifdef O_DIRECT
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    if (db_fd_ == -1) {
+      // e.g. tmpfs does not support O_DIRECT
+      LOG_WARN("can't open db file with O_DIRECT, falling back to buffered I/O");
+    }
+    direct_io_ = db_fd_ != -1;
+  }
+#endif
+  if (db_fd_ == -1) {
+    // directory or file does not exist, create a new file
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+    if (db_fd_ == -1) {
       throw Exception("can't open db file");
     }
   }
+#if defined(F_NOCACHE) && !defined(O_DIRECT)
+  // macOS spells O_DIRECT as a fcntl
+  if (direct_io) {
+    direct_io_ = fcntl(db_fd_, F_NOCACHE, 1) != -1;
+  }
+#endif
   buffer_used = nullptr;
+  ReadFreePageMap();
+}
+
+DiskManager::~DiskManager() {
+  if (db_fd_ != -1) {
+    try {
+      WriteFreePageMap();
+    } catch (const Exception &e) {
+      LOG_WARN("can't write the free page map: %s", e.what());
+    }
+    close(db_fd_);
+  }
 }
 
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
+  WriteFreePageMap();
   {
     std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+    if (db_fd_ != -1) {
+      close(db_fd_);
+      db_fd_ = -1;
+    }
   }
   log_io_.close();
 }
@@ -78,48 +113,226 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
-  // set write cursor to offset
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
-    return;
+  {
+    // the page's allocation has to reach the file before its data does, or a process crash would let it be handed
+    // out again; nothing is synced, so this does not hold across an OS crash or power loss
+    std::scoped_lock lock(free_map_latch_);
+    auto map_page = static_cast<size_t>(page_id) / FREE_MAP_PAGE_SPAN;
+    if (map_page < free_map_dirty_.size() && free_map_dirty_[map_page]) {
+      WriteMapPageLocked(map_page);
+    }
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  WriteAt(PageOffset(page_id), page_data);
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
-void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
-      return;
+void DiskManager::ReadPage(page_id_t page_id, char *page_data) { ReadAt(PageOffset(page_id), page_data); }
+
+auto DiskManager::PageOffset(page_id_t page_id) -> off_t {
+  auto id = static_cast<off_t>(page_id);
+  return (id + id / static_cast<off_t>(FREE_MAP_PAGE_SPAN) + 2) * BUSTUB_PAGE_SIZE;
+}
+
+auto DiskManager::MapPageOffset(size_t map_page) -> off_t {
+  return static_cast<off_t>(map_page * (FREE_MAP_PAGE_SPAN + 1) + 1) * BUSTUB_PAGE_SIZE;
+}
+
+void DiskManager::WriteAt(off_t offset, const char *page_data) {
+  if (direct_io_ && reinterpret_cast<uintptr_t>(page_data) % BUSTUB_PAGE_SIZE != 0) {
+    // direct I/O needs an aligned buffer
+    alignas(BUSTUB_PAGE_SIZE) thread_local char bounce[BUSTUB_PAGE_SIZE];
+    memcpy(bounce, page_data, BUSTUB_PAGE_SIZE);
+    page_data = bounce;
+  }
+
+  ssize_t write_count = 0;
+  while (write_count < BUSTUB_PAGE_SIZE) {
+    ssize_t n = pwrite(db_fd_, page_data + write_count, BUSTUB_PAGE_SIZE - write_count, offset + write_count);
+    // check for I/O error
+    if (n == -1 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      throw Exception(std::string("I/O error while writing: ") + (n == -1 ? strerror(errno) : "nothing written"));
+    }
+    write_count += n;
+  }
+}
+
+void DiskManager::ReadAt(off_t offset, char *page_data) {
+  char *buffer = page_data;
+  alignas(BUSTUB_PAGE_SIZE) thread_local char bounce[BUSTUB_PAGE_SIZE];
+  if (direct_io_ && reinterpret_cast<uintptr_t>(page_data) % BUSTUB_PAGE_SIZE != 0) {
+    // direct I/O needs an aligned buffer
+    buffer = bounce;
+  }
+
+  ssize_t read_count = 0;
+  while (read_count < BUSTUB_PAGE_SIZE) {
+    ssize_t n = pread(db_fd_, buffer + read_count, BUSTUB_PAGE_SIZE - read_count, offset + read_count);
+    if (n == -1 && errno == EINTR) {
+      continue;
+    }
+    if (n == -1) {
+      throw Exception(std::string("I/O error while reading: ") + strerror(errno));
+    }
+    if (n == 0) {
+      if (read_count != 0) {
+        // pages are written whole, so the file cannot end inside one
+        throw Exception("db file ends in the middle of a page");
+      }
+      // a page that was allocated but never written
+      memset(buffer, 0, BUSTUB_PAGE_SIZE);
+      break;
     }
-    // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+    read_count += n;
+  }
+
+  if (buffer != page_data) {
+    memcpy(page_data, buffer, BUSTUB_PAGE_SIZE);
+  }
+}
+
+auto DiskManager::AllocatePage(uint32_t stride, uint32_t offset) -> page_id_t {
+  BUSTUB_ASSERT(offset < stride, "offset must be less than the stride");
+  std::scoped_lock lock(free_map_latch_);
+  if (alloc_hints_.size() != stride) {
+    alloc_hints_.resize(stride);
+    for (uint32_t i = 0; i < stride; i++) {
+      alloc_hints_[i] = static_cast<page_id_t>(i);
     }
   }
+
+  page_id_t page_id = alloc_hints_[offset];
+  while (IsAllocatedLocked(page_id)) {
+    page_id += static_cast<page_id_t>(stride);
+  }
+  SetAllocatedLocked(page_id, true);
+  alloc_hints_[offset] = page_id + static_cast<page_id_t>(stride);
+  return page_id;
+}
+
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock lock(free_map_latch_);
+  if (page_id < 0 || !IsAllocatedLocked(page_id)) {
+    return;
+  }
+  SetAllocatedLocked(page_id, false);
+  if (!alloc_hints_.empty()) {
+    auto &hint = alloc_hints_[page_id % alloc_hints_.size()];
+    hint = std::min(hint, page_id);
+  }
+}
+
+auto DiskManager::IsAllocated(page_id_t page_id) -> bool {
+  std::scoped_lock lock(free_map_latch_);
+  return page_id >= 0 && IsAllocatedLocked(page_id);
+}
+
+auto DiskManager::GetFragmentation() -> DiskFragmentation {
+  std::scoped_lock lock(free_map_latch_);
+  DiskFragmentation fragmentation;
+  // the file only has to hold the pages up to the last allocated one
+  size_t word = free_map_.size();
+  while (word > 0 && free_map_[word - 1] == 0) {
+    word--;
+  }
+  if (word == 0) {
+    return fragmentation;
+  }
+  fragmentation.num_pages_ = word * 64 - __builtin_clzll(free_map_[word - 1]);
+
+  size_t run = 0;
+  for (size_t page = 0; page < fragmentation.num_pages_; page++) {
+    if (IsAllocatedLocked(static_cast<page_id_t>(page))) {
+      run = 0;
+      continue;
+    }
+    fragmentation.num_free_pages_++;
+    if (run++ == 0) {
+      fragmentation.num_free_runs_++;
+    }
+    fragmentation.largest_free_run_ = std::max(fragmentation.largest_free_run_, run);
+  }
+  return fragmentation;
+}
+
+void DiskManager::WriteFreePageMap() {
+  std::scoped_lock lock(free_map_latch_);
+  WriteFreePageMapLocked();
+}
+
+void DiskManager::WriteFreePageMapLocked() {
+  if (db_fd_ == -1) {
+    return;
+  }
+  for (size_t map_page = 0; map_page < free_map_dirty_.size(); map_page++) {
+    if (free_map_dirty_[map_page]) {
+      WriteMapPageLocked(map_page);
+    }
+  }
+}
+
+void DiskManager::WriteMapPageLocked(size_t map_page) {
+  if (db_fd_ == -1) {
+    return;
+  }
+  WriteAt(MapPageOffset(map_page),
+          reinterpret_cast<const char *>(free_map_.data() + map_page * FREE_MAP_WORDS_PER_PAGE));
+  free_map_dirty_[map_page] = false;
+}
+
+void DiskManager::ReadFreePageMap() {
+  std::scoped_lock lock(free_map_latch_);
+  off_t file_size = GetFileSize(file_name_);
+  alignas(BUSTUB_PAGE_SIZE) char header[BUSTUB_PAGE_SIZE] = {0};
+  if (file_size == 0) {
+    // a new file, stamp it with the format it is written in
+    memcpy(header, DB_FILE_MAGIC, sizeof(DB_FILE_MAGIC));
+    memcpy(header + sizeof(DB_FILE_MAGIC), &DB_FILE_VERSION, sizeof(DB_FILE_VERSION));
+    WriteAt(0, header);
+    return;
+  }
+  ReadAt(0, header);
+  uint32_t version;
+  memcpy(&version, header + sizeof(DB_FILE_MAGIC), sizeof(version));
+  if (memcmp(header, DB_FILE_MAGIC, sizeof(DB_FILE_MAGIC)) != 0 || version != DB_FILE_VERSION) {
+    // e.g. a file written before the header and the free page map existed, whose pages would be read at wrong offsets
+    close(db_fd_);
+    db_fd_ = -1;
+    throw Exception("db file is not in the format of this version of BusTub");
+  }
+  // past the header, a file of n pages holds the map pages at the start of every span it reaches into
+  auto file_pages = static_cast<size_t>(file_size) / BUSTUB_PAGE_SIZE - 1;
+  size_t num_map_pages = (file_pages + FREE_MAP_PAGE_SPAN) / (FREE_MAP_PAGE_SPAN + 1);
+  free_map_.resize(num_map_pages * FREE_MAP_WORDS_PER_PAGE);
+  free_map_dirty_.assign(num_map_pages, false);
+  for (size_t map_page = 0; map_page < num_map_pages; map_page++) {
+    ReadAt(MapPageOffset(map_page), reinterpret_cast<char *>(free_map_.data() + map_page * FREE_MAP_WORDS_PER_PAGE));
+  }
+}
+
+auto DiskManager::IsAllocatedLocked(page_id_t page_id) const -> bool {
+  auto page = static_cast<size_t>(page_id);
+  return page / 64 < free_map_.size() && ((free_map_[page / 64] >> (page % 64)) & 1) != 0;
+}
+
+void DiskManager::SetAllocatedLocked(page_id_t page_id, bool allocated) {
+  auto page = static_cast<size_t>(page_id);
+  size_t map_page = page / FREE_MAP_PAGE_SPAN;
+  if (map_page >= free_map_dirty_.size()) {
+    free_map_.resize((map_page + 1) * FREE_MAP_WORDS_PER_PAGE, 0);
+    free_map_dirty_.resize(map_page + 1, true);
+  }
+  if (allocated) {
+    free_map_[page / 64] |= static_cast<uint64_t>(1) << (page % 64);
+  } else {
+    free_map_[page / 64] &= ~(static_cast<uint64_t>(1) << (page % 64));
+  }
+  free_map_dirty_[map_page] = true;
 }
 
 /**
@@ -202,10 +415,10 @@ auto DiskManager::GetFlushState() const -> bool { return flush_log_; }
 /**
  * Private helper function to get disk file size
  */
-auto DiskManager::GetFileSize(const std::string &file_name) -> int {
+auto DiskManager::GetFileSize(const std::string &file_name) -> off_t {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? stat_buf.st_size : -1;
 }
 
 }  // namespace bustub
@@ -26,7 +26,32 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t root_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+  if (!lazy_merge_threshold_.has_value()) {
+    return false;
+  }
+  guard.Drop();
+  // Lazy removes leave empty leaves behind until they are compacted, so look for the first key. The sibling pointer of
+  // an unlatched leaf may already name a deleted page, so each further leaf is found from the root, like IndexIterator
+  // does.
+  std::optional<KeyType> high_key;
+  std::optional<ReadPageGuard> leaf_guard = FindLeafRead(std::nullopt, &high_key);
+  while (leaf_guard.has_value() && leaf_guard->As<LeafPage>()->GetSize() == 0) {
+    if (!high_key.has_value()) {
+      return true;
+    }
+    leaf_guard.reset();
+    KeyType key = *high_key;
+    high_key.reset();
+    leaf_guard = FindLeafRead(key, &high_key);
+  }
+  return !leaf_guard.has_value();
+}
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -37,9 +62,140 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  // Declaration of context instance.
-  Context ctx;
-  (void)ctx;
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  // Latch crabbing: the child is latched before the parent guard is overwritten and released.
+  guard = bpm_->FetchPageRead(page_id);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    auto *internal = guard.As<InternalPage>();
+    guard = bpm_->FetchPageRead(internal->ValueAt(internal->Lookup(key, comparator_)));
+  }
+  auto *leaf = guard.As<LeafPage>();
+  int index = leaf->KeyIndex(key, comparator_);
+  if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+    return false;
+  }
+  result->push_back(leaf->ValueAt(index));
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::ScanRange(KeyRangeScan<KeyType> *scan, std::vector<ValueType> *result) -> bool {
+  return scan->reverse_ ? ScanRangeReverse(scan, result) : ScanRangeForward(scan, result);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::ScanRange(KeyRangeScan<KeyType> *scan, std::vector<MappingType> *result) -> bool {
+  return scan->reverse_ ? ScanRangeReverse(scan, result) : ScanRangeForward(scan, result);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename Entry>
+auto BPLUSTREE_TYPE::ScanRangeForward(KeyRangeScan<KeyType> *scan, std::vector<Entry> *result) -> bool {
+  while (!scan->done_) {
+    // The next batch starts at the high key of this leaf.
+    std::optional<KeyType> high_key;
+    std::optional<ReadPageGuard> guard = FindLeafRead(scan->lower_, &high_key);
+    if (!guard.has_value()) {
+      scan->done_ = true;
+      break;
+    }
+
+    auto *leaf = guard->As<LeafPage>();
+    int index = 0;
+    if (scan->lower_.has_value()) {
+      index = leaf->KeyIndex(*scan->lower_, comparator_);
+      if (!scan->lower_inclusive_ && index < leaf->GetSize() && comparator_(leaf->KeyAt(index), *scan->lower_) == 0) {
+        index++;
+      }
+    }
+    auto past_upper = [&](const KeyType &key) {
+      int cmp = comparator_(key, *scan->upper_);
+      return cmp > 0 || (cmp == 0 && !scan->upper_inclusive_);
+    };
+    size_t batch_start = result->size();
+    for (; index < leaf->GetSize(); index++) {
+      if (scan->upper_.has_value() && past_upper(leaf->KeyAt(index))) {
+        scan->done_ = true;
+        break;
+      }
+      AppendEntry(leaf, index, result);
+    }
+    if (!high_key.has_value() || (scan->upper_.has_value() && past_upper(*high_key))) {
+      scan->done_ = true;
+    } else {
+      scan->lower_ = high_key;
+      scan->lower_inclusive_ = true;
+    }
+    if (result->size() > batch_start) {
+      return true;
+    }
+  }
+  return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename Entry>
+auto BPLUSTREE_TYPE::ScanRangeReverse(KeyRangeScan<KeyType> *scan, std::vector<Entry> *result) -> bool {
+  while (!scan->done_) {
+    ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+    page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+    if (page_id == INVALID_PAGE_ID) {
+      scan->done_ = true;
+      break;
+    }
+    // The mirror image of the forward scan: remember the largest separator on the path taken. Every key of the leaf
+    // is at least as large and every key of the preceding leaves is below it, so the next batch ends there. An
+    // exclusive upper bound that equals a separator leads to the child left of it, which holds the keys below it.
+    std::optional<KeyType> low_key;
+    guard = bpm_->FetchPageRead(page_id);
+    while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+      auto *internal = guard.As<InternalPage>();
+      int index = internal->GetSize() - 1;
+      if (scan->upper_.has_value()) {
+        index = internal->Lookup(*scan->upper_, comparator_);
+        if (!scan->upper_inclusive_ && index > 0 && comparator_(internal->KeyAt(index), *scan->upper_) == 0) {
+          index--;
+        }
+      }
+      if (index > 0) {
+        low_key = internal->KeyAt(index);
+      }
+      guard = bpm_->FetchPageRead(internal->ValueAt(index));
+    }
+
+    auto *leaf = guard.As<LeafPage>();
+    int end = leaf->GetSize();
+    if (scan->upper_.has_value()) {
+      end = leaf->KeyIndex(*scan->upper_, comparator_);
+      if (scan->upper_inclusive_ && end < leaf->GetSize() && comparator_(leaf->KeyAt(end), *scan->upper_) == 0) {
+        end++;
+      }
+    }
+    size_t batch_start = result->size();
+    for (int index = end - 1; index >= 0; index--) {
+      if (scan->lower_.has_value()) {
+        int cmp = comparator_(leaf->KeyAt(index), *scan->lower_);
+        if (cmp < 0 || (cmp == 0 && !scan->lower_inclusive_)) {
+          scan->done_ = true;
+          break;
+        }
+      }
+      AppendEntry(leaf, index, result);
+    }
+    if (!low_key.has_value() || (scan->lower_.has_value() && comparator_(*low_key, *scan->lower_) <= 0)) {
+      scan->done_ = true;
+    } else {
+      scan->upper_ = low_key;
+      scan->upper_inclusive_ = false;
+    }
+    if (result->size() > batch_start) {
+      return true;
+    }
+  }
   return false;
 }
 
@@ -55,10 +211,194 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
-  // Declaration of context instance.
+  // Most inserts do not split, so first try with read latches on the inner pages and a write latch on the leaf only.
+  {
+    Context ctx;
+    std::optional<WritePageGuard> leaf_guard = FindLeafOptimistic(key, ctx);
+    if (leaf_guard.has_value()) {
+      auto *leaf = leaf_guard->As<LeafPage>();
+      int index = leaf->KeyIndex(key, comparator_);
+      if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+        return false;
+      }
+      if (leaf->HasRoomFor(key)) {
+        leaf_guard->AsMut<LeafPage>()->InsertAt(index, key, value);
+        return true;
+      }
+    }
+  }
+
+  // The leaf would split (or the tree is empty): retry holding write latches on every page that might change.
   Context ctx;
-  (void)ctx;
-  return false;
+  FindLeafPessimistic(key, ctx, [&key](page_id_t /* page_id */, const BPlusTreePage *page) {
+    if (page->IsLeafPage()) {
+      return static_cast<const LeafPage *>(page)->HasRoomFor(key);
+    }
+    return !static_cast<const InternalPage *>(page)->IsFull();
+  });
+  if (ctx.write_set_.empty()) {
+    page_id_t root_page_id;
+    WritePageGuard root_guard = NewPageWrite(&root_page_id);
+    auto *root = root_guard.AsMut<LeafPage>();
+    root->Init(leaf_max_size_);
+    root->InsertAt(0, key, value);
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+    return true;
+  }
+
+  auto *leaf = ctx.write_set_.back().As<LeafPage>();
+  int index = leaf->KeyIndex(key, comparator_);
+  if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+    return false;
+  }
+  if (leaf->HasRoomFor(key)) {
+    ctx.write_set_.back().AsMut<LeafPage>()->InsertAt(index, key, value);
+    return true;
+  }
+
+  // Split the full leaf: lay the entries out with the new one in place, then give the upper half to a new page.
+  auto *full_leaf = ctx.write_set_.back().AsMut<LeafPage>();
+  std::vector<MappingType> items;
+  items.reserve(full_leaf->GetSize() + 1);
+  for (int i = 0; i < full_leaf->GetSize(); i++) {
+    items.push_back(full_leaf->ItemAt(i));
+  }
+  items.insert(items.begin() + index, MappingType{key, value});
+
+  page_id_t new_page_id;
+  WritePageGuard new_guard = NewPageWrite(&new_page_id);
+  auto *new_leaf = new_guard.AsMut<LeafPage>();
+  new_leaf->Init(leaf_max_size_);
+  int left_size = full_leaf->SplitPoint(items);
+  full_leaf->SetSize(0);
+  for (int i = 0; i < static_cast<int>(items.size()); i++) {
+    if (i < left_size) {
+      full_leaf->InsertAt(i, items[i].first, items[i].second);
+    } else {
+      new_leaf->InsertAt(i - left_size, items[i].first, items[i].second);
+    }
+  }
+  new_leaf->SetNextPageId(full_leaf->GetNextPageId());
+  full_leaf->SetNextPageId(new_page_id);
+  KeyType separator = InternalPage::ShortestSeparator(items[left_size - 1].first, items[left_size].first);
+  new_guard.Drop();
+  InsertIntoParent(ctx, separator, new_page_id);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(Context &ctx, const KeyType &key, page_id_t right_page_id) {
+  page_id_t left_page_id = ctx.write_set_.back().PageId();
+  ctx.write_set_.pop_back();
+
+  if (ctx.write_set_.empty()) {
+    // The split page was the root; it was not safe, so the header is still latched.
+    BUSTUB_ASSERT(ctx.header_page_.has_value(), "splitting the root without the header latch");
+    page_id_t root_page_id;
+    WritePageGuard root_guard = NewPageWrite(&root_page_id);
+    auto *root = root_guard.AsMut<InternalPage>();
+    root->Init(internal_max_size_);
+    root->InsertAt(0, KeyType{}, left_page_id);
+    root->InsertAt(1, key, right_page_id);
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+    return;
+  }
+
+  auto *parent = ctx.write_set_.back().AsMut<InternalPage>();
+  int index = parent->ValueIndex(left_page_id) + 1;
+  if (!parent->IsFull()) {
+    parent->InsertAt(index, key, right_page_id);
+    return;
+  }
+
+  std::vector<std::pair<KeyType, page_id_t>> items;
+  items.reserve(parent->GetSize() + 1);
+  for (int i = 0; i < parent->GetSize(); i++) {
+    items.emplace_back(parent->KeyAt(i), parent->ValueAt(i));
+  }
+  items.insert(items.begin() + index, {key, right_page_id});
+
+  page_id_t new_page_id;
+  WritePageGuard new_guard = NewPageWrite(&new_page_id);
+  auto *new_internal = new_guard.AsMut<InternalPage>();
+  new_internal->Init(internal_max_size_);
+  int left_size = parent->SplitPoint(items);
+  parent->SetSize(0);
+  for (int i = 0; i < static_cast<int>(items.size()); i++) {
+    if (i < left_size) {
+      parent->InsertAt(i, items[i].first, items[i].second);
+    } else {
+      new_internal->InsertAt(i - left_size, items[i].first, items[i].second);
+    }
+  }
+  // The first key of the new page moves up; it stays behind in slot 0, where it is never read.
+  KeyType separator = new_internal->KeyAt(0);
+  new_guard.Drop();
+  InsertIntoParent(ctx, separator, new_page_id);
+}
+
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &items, double fill_factor, Transaction *txn) -> bool {
+  for (size_t i = 1; i < items.size(); i++) {
+    if (comparator_(items[i - 1].first, items[i].first) >= 0) {
+      return false;
+    }
+  }
+  // The header stays latched until the root is published, so concurrent operations wait for the whole tree.
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  if (header_guard.As<BPlusTreeHeaderPage>()->root_page_id_ != INVALID_PAGE_ID) {
+    return false;
+  }
+  if (items.empty()) {
+    return true;
+  }
+
+  // Leaf level. Only the previous leaf stays pinned, to link it to the next one.
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  WritePageGuard prev_guard;
+  int next_item = 0;
+  for (int size : LeafPage::BulkLoadSizes(items, leaf_max_size_, fill_factor)) {
+    page_id_t page_id;
+    WritePageGuard guard = NewPageWrite(&page_id);
+    auto *leaf = guard.AsMut<LeafPage>();
+    leaf->Init(leaf_max_size_);
+    int first_item = next_item;
+    for (int i = 0; i < size; i++, next_item++) {
+      leaf->InsertAt(i, items[next_item].first, items[next_item].second);
+    }
+    if (level.empty()) {
+      level.emplace_back(leaf->KeyAt(0), page_id);
+    } else {
+      prev_guard.AsMut<LeafPage>()->SetNextPageId(page_id);
+      level.emplace_back(InternalPage::ShortestSeparator(items[first_item - 1].first, leaf->KeyAt(0)), page_id);
+    }
+    prev_guard = std::move(guard);
+  }
+  prev_guard.Drop();
+
+  // Internal levels, each made of the first keys and page ids of the level below, until a single root is left.
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    int next_child = 0;
+    for (int size : InternalPage::BulkLoadSizes(level, internal_max_size_, fill_factor)) {
+      page_id_t page_id;
+      WritePageGuard guard = NewPageWrite(&page_id);
+      auto *internal = guard.AsMut<InternalPage>();
+      internal->Init(internal_max_size_);
+      for (int i = 0; i < size; i++, next_child++) {
+        internal->InsertAt(i, level[next_child].first, level[next_child].second);
+      }
+      // The first key is never read in this node; it becomes the separator in the parent.
+      parents.emplace_back(internal->KeyAt(0), page_id);
+    }
+    level = std::move(parents);
+  }
+
+  header_guard.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = level[0].second;
+  return true;
 }
 
 /*****************************************************************************
@@ -73,9 +413,379 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  // Declaration of context instance.
+  if (lazy_merge_threshold_.has_value()) {
+    Context ctx;
+    std::optional<WritePageGuard> leaf_guard = FindLeafOptimistic(key, ctx);
+    if (!leaf_guard.has_value()) {
+      return;
+    }
+    auto *leaf = leaf_guard->AsMut<LeafPage>();
+    int index = leaf->KeyIndex(key, comparator_);
+    if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+      return;
+    }
+    bool was_below = leaf->IsBelowMergeThreshold(*lazy_merge_threshold_);
+    leaf->RemoveAt(index);
+    // Only the remove that takes the leaf below the threshold queues it; later ones find it queued already. A root
+    // leaf is never compacted below the threshold, so it is queued again once it is empty.
+    bool crossed = (!was_below && leaf->IsBelowMergeThreshold(*lazy_merge_threshold_)) ||
+                   (leaf->GetSize() == 0 && ctx.IsRootPage(leaf_guard->PageId()));
+    leaf_guard->Drop();
+    if (crossed) {
+      std::scoped_lock lock(underflow_latch_);
+      underflow_keys_.push_back(key);
+      compaction_cv_.notify_one();
+    }
+    return;
+  }
+
+  {
+    Context ctx;
+    std::optional<WritePageGuard> leaf_guard = FindLeafOptimistic(key, ctx);
+    if (!leaf_guard.has_value()) {
+      return;
+    }
+    auto *leaf = leaf_guard->As<LeafPage>();
+    int index = leaf->KeyIndex(key, comparator_);
+    if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+      return;
+    }
+    // The root may have changed since the header was released, so a leaf that would be safe only as the root does
+    // not count here.
+    if (leaf->IsSafeToRemove() && leaf->GetSize() > 1) {
+      leaf_guard->AsMut<LeafPage>()->RemoveAt(index);
+      return;
+    }
+  }
+
   Context ctx;
-  (void)ctx;
+  FindLeafPessimistic(key, ctx, [&ctx](page_id_t page_id, const BPlusTreePage *page) {
+    if (ctx.IsRootPage(page_id)) {
+      // The root may go below the minimum size; it only changes once a leaf root empties or an internal root is down
+      // to a single child.
+      return page->GetSize() > (page->IsLeafPage() ? 1 : 2);
+    }
+    return IsSafeToRemove(page);
+  });
+  if (ctx.write_set_.empty()) {
+    return;
+  }
+  auto *leaf = ctx.write_set_.back().As<LeafPage>();
+  int index = leaf->KeyIndex(key, comparator_);
+  if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+    return;
+  }
+  ctx.write_set_.back().AsMut<LeafPage>()->RemoveAt(index);
+  HandleUnderflow(ctx);
+  ReleaseContext(ctx);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseContext(Context &ctx) {
+  ctx.header_page_ = std::nullopt;
+  ctx.write_set_.clear();
+  ctx.read_set_.clear();
+  for (page_id_t page_id : ctx.deleted_pages_) {
+    // A reader that peeked at the page before it was unlinked may still hold a pin. The page is unreachable by then,
+    // so failing to delete it only leaks it.
+    bpm_->DeletePage(page_id);
+  }
+  ctx.deleted_pages_.clear();
+}
+
+/*****************************************************************************
+ * LAZY MERGING
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::EnableLazyMerge(double merge_threshold) { lazy_merge_threshold_ = merge_threshold; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::CompactUnderflows(size_t max_leaves) -> size_t {
+  size_t processed = 0;
+  for (; processed < max_leaves; processed++) {
+    KeyType key;
+    {
+      std::scoped_lock lock(underflow_latch_);
+      if (underflow_keys_.empty()) {
+        break;
+      }
+      key = underflow_keys_.front();
+      underflow_keys_.pop_front();
+    }
+    // A merge with a sibling that is below the threshold as well leaves the merged leaf below it, so keep going
+    // until the leaf the key leads to is not.
+    while (CompactLeaf(key)) {
+    }
+  }
+  return processed;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::CompactLeaf(const KeyType &key) -> bool {
+  Context ctx;
+  FindLeafPessimistic(key, ctx, [&ctx, this](page_id_t page_id, const BPlusTreePage *page) {
+    if (ctx.IsRootPage(page_id)) {
+      return page->GetSize() > (page->IsLeafPage() ? 0 : 2);
+    }
+    // Leaves at or above the threshold are left as they are; below it they may merge into their parent.
+    if (page->IsLeafPage()) {
+      return !static_cast<const LeafPage *>(page)->IsBelowMergeThreshold(*lazy_merge_threshold_);
+    }
+    return IsSafeToRemove(page);
+  });
+  if (ctx.write_set_.empty()) {
+    return false;
+  }
+  // The leaf may have refilled or been compacted already since it was queued. A root leaf only goes once empty.
+  auto *leaf = ctx.write_set_.back().As<LeafPage>();
+  bool changed = leaf->IsBelowMergeThreshold(*lazy_merge_threshold_) &&
+                 !(ctx.IsRootPage(ctx.write_set_.back().PageId()) && leaf->GetSize() > 0);
+  if (changed) {
+    changed = HandleUnderflow(ctx);
+  }
+  ReleaseContext(ctx);
+  return changed;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartBackgroundCompaction() {
+  std::scoped_lock lock(underflow_latch_);
+  if (compaction_running_) {
+    return;
+  }
+  compaction_running_ = true;
+  compaction_thread_ = std::thread(&BPlusTree::BackgroundCompaction, this);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StopBackgroundCompaction() {
+  {
+    std::scoped_lock lock(underflow_latch_);
+    if (!compaction_running_) {
+      return;
+    }
+    compaction_running_ = false;
+  }
+  compaction_cv_.notify_one();
+  compaction_thread_.join();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BackgroundCompaction() {
+  while (true) {
+    {
+      std::unique_lock lock(underflow_latch_);
+      compaction_cv_.wait(lock, [this] { return !compaction_running_ || !underflow_keys_.empty(); });
+      if (!compaction_running_) {
+        return;
+      }
+    }
+    // One leaf at a time, so that stopping never waits for more than one.
+    CompactUnderflows(1);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::HandleUnderflow(Context &ctx) -> bool {
+  bool changed = false;
+  while (true) {
+    WritePageGuard &guard = ctx.write_set_.back();
+    auto *node = guard.As<BPlusTreePage>();
+    if (ctx.IsRootPage(guard.PageId())) {
+      if (node->IsLeafPage() && node->GetSize() == 0) {
+        ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = INVALID_PAGE_ID;
+        ctx.deleted_pages_.push_back(guard.PageId());
+        return true;
+      }
+      if (!node->IsLeafPage() && node->GetSize() == 1) {
+        ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = guard.As<InternalPage>()->ValueAt(0);
+        ctx.deleted_pages_.push_back(guard.PageId());
+        return true;
+      }
+      return changed;
+    }
+    if (!IsUnderfull(node)) {
+      return changed;
+    }
+
+    auto *parent = ctx.write_set_[ctx.write_set_.size() - 2].AsMut<InternalPage>();
+    int index = parent->ValueIndex(guard.PageId());
+    bool from_left = index > 0;
+    // The sibling is latched while node is held, which is right to left when from_left. That cannot deadlock: the
+    // parent's write latch keeps out every other structure modification of these two pages, optimistic writers and
+    // readers hold at most one latch per level, and an IndexIterator drops its leaf before it descends to the next.
+    // Whoever adds another place that latches two pages of one level has to keep it that way.
+    WritePageGuard sibling_guard = bpm_->FetchPageWrite(parent->ValueAt(from_left ? index - 1 : index + 1));
+    WritePageGuard &left_guard = from_left ? sibling_guard : guard;
+    WritePageGuard &right_guard = from_left ? guard : sibling_guard;
+    int separator_index = from_left ? index : index + 1;
+
+    // With variable-length keys an entry moved over, or the separator that replaces the parent's, may not fit. The
+    // page then stays underfull, which lookups and scans handle like the empty leaves lazy merging leaves behind.
+    if (node->IsLeafPage()) {
+      auto *left = left_guard.AsMut<LeafPage>();
+      auto *right = right_guard.AsMut<LeafPage>();
+      if (left->CanAbsorb(right)) {
+        right->MoveSuffixTo(0, left);
+        left->SetNextPageId(right->GetNextPageId());
+      } else {
+        int last = left->GetSize() - 1;
+        if ((from_left ? left : right)->GetSize() < 2) {
+          return changed;
+        }
+        KeyType moved = from_left ? left->KeyAt(last) : right->KeyAt(0);
+        KeyType separator = from_left ? InternalPage::ShortestSeparator(left->KeyAt(last - 1), moved)
+                                      : InternalPage::ShortestSeparator(moved, right->KeyAt(1));
+        if (!(from_left ? right : left)->HasRoomFor(moved) || !parent->CanSetKeyAt(separator_index, separator)) {
+          return changed;
+        }
+        if (from_left) {
+          right->InsertAt(0, moved, left->ValueAt(last));
+          left->RemoveAt(last);
+        } else {
+          left->InsertAt(left->GetSize(), moved, right->ValueAt(0));
+          right->RemoveAt(0);
+        }
+        parent->SetKeyAt(separator_index, separator);
+        return true;
+      }
+    } else {
+      auto *left = left_guard.AsMut<InternalPage>();
+      auto *right = right_guard.AsMut<InternalPage>();
+      if (left->CanAbsorb(right, parent->KeyAt(separator_index))) {
+        // The parent's separator comes down as the key of right's first child.
+        int left_size = left->GetSize();
+        right->MoveSuffixTo(0, left);
+        left->SetKeyAt(left_size, parent->KeyAt(separator_index));
+      } else {
+        // Rotate one child through the parent's separator.
+        if (from_left) {
+          int last = left->GetSize() - 1;
+          if (!parent->CanSetKeyAt(separator_index, left->KeyAt(last))) {
+            return changed;
+          }
+          right->SetKeyAt(0, parent->KeyAt(separator_index));
+          right->InsertAt(0, KeyType{}, left->ValueAt(last));
+          parent->SetKeyAt(separator_index, left->KeyAt(last));
+          left->RemoveAt(last);
+        } else {
+          if (!parent->CanSetKeyAt(separator_index, right->KeyAt(1))) {
+            return changed;
+          }
+          left->InsertAt(left->GetSize(), parent->KeyAt(separator_index), right->ValueAt(0));
+          parent->SetKeyAt(separator_index, right->KeyAt(1));
+          right->RemoveAt(0);
+        }
+        return true;
+      }
+    }
+
+    // The right page was merged into the left one: unlink it and continue with the parent.
+    ctx.deleted_pages_.push_back(right_guard.PageId());
+    parent->RemoveAt(separator_index);
+    sibling_guard.Drop();
+    ctx.write_set_.pop_back();
+    changed = true;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsUnderfull(const BPlusTreePage *page) -> bool {
+  if (page->IsLeafPage()) {
+    return static_cast<const LeafPage *>(page)->IsUnderfull();
+  }
+  return static_cast<const InternalPage *>(page)->IsUnderfull();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafeToRemove(const BPlusTreePage *page) -> bool {
+  if (page->IsLeafPage()) {
+    return static_cast<const LeafPage *>(page)->IsSafeToRemove();
+  }
+  return static_cast<const InternalPage *>(page)->IsSafeToRemove();
+}
+
+/*****************************************************************************
+ * LATCH CRABBING
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafRead(const std::optional<KeyType> &key, std::optional<KeyType> *high_key) const
+    -> std::optional<ReadPageGuard> {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return std::nullopt;
+  }
+  guard = bpm_->FetchPageRead(page_id);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    auto *internal = guard.As<InternalPage>();
+    int index = key.has_value() ? internal->Lookup(*key, comparator_) : 0;
+    if (index + 1 < internal->GetSize()) {
+      *high_key = internal->KeyAt(index + 1);
+    }
+    guard = bpm_->FetchPageRead(internal->ValueAt(index));
+  }
+  return guard;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType &key, Context &ctx) -> std::optional<WritePageGuard> {
+  ReadPageGuard header_guard = bpm_->FetchPageRead(header_page_id_);
+  ctx.root_page_id_ = header_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+    return std::nullopt;
+  }
+  ctx.read_set_.push_back(std::move(header_guard));
+
+  page_id_t page_id = ctx.root_page_id_;
+  while (true) {
+    // The page type decides the latch mode. It can be read before latching: the page is pinned, its parent is
+    // read-latched so it cannot be merged away, and a page never changes between leaf and internal.
+    Page *page = bpm_->FetchPage(page_id);
+    BUSTUB_ENSURE(page != nullptr, "B+ tree page could not be fetched");
+    if (reinterpret_cast<const BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+      page->WLatch();
+      ctx.read_set_.clear();
+      return WritePageGuard{bpm_, page};
+    }
+    page->RLatch();
+    ReadPageGuard guard{bpm_, page};
+    ctx.read_set_.clear();
+    auto *internal = guard.As<InternalPage>();
+    page_id = internal->ValueAt(internal->Lookup(key, comparator_));
+    ctx.read_set_.push_back(std::move(guard));
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename SafePredicate>
+void BPLUSTREE_TYPE::FindLeafPessimistic(const KeyType &key, Context &ctx, SafePredicate &&is_safe) {
+  ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+  ctx.root_page_id_ = ctx.header_page_->As<BPlusTreeHeaderPage>()->root_page_id_;
+  page_id_t page_id = ctx.root_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    ctx.write_set_.push_back(bpm_->FetchPageWrite(page_id));
+    auto *page = ctx.write_set_.back().As<BPlusTreePage>();
+    if (is_safe(page_id, page)) {
+      ctx.header_page_ = std::nullopt;
+      while (ctx.write_set_.size() > 1) {
+        ctx.write_set_.pop_front();
+      }
+    }
+    if (page->IsLeafPage()) {
+      return;
+    }
+    auto *internal = ctx.write_set_.back().As<InternalPage>();
+    page_id = internal->ValueAt(internal->Lookup(key, comparator_));
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewPageWrite(page_id_t *page_id) -> WritePageGuard {
+  Page *page = bpm_->NewPage(page_id);
+  BUSTUB_ENSURE(page != nullptr, "no frame available for a new B+ tree page");
+  page->WLatch();
+  return {bpm_, page};
 }
 
 /*****************************************************************************
@@ -87,7 +797,14 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  std::optional<KeyType> high_key;
+  std::optional<ReadPageGuard> guard = FindLeafRead(std::nullopt, &high_key);
+  if (!guard.has_value()) {
+    return INDEXITERATOR_TYPE();
+  }
+  return INDEXITERATOR_TYPE(this, std::move(*guard), 0, high_key);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -95,7 +812,15 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE()
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  std::optional<KeyType> high_key;
+  std::optional<ReadPageGuard> guard = FindLeafRead(key, &high_key);
+  if (!guard.has_value()) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = guard->As<LeafPage>()->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(this, std::move(*guard), index, high_key);
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -109,7 +834,10 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE();
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+}
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -9,7 +9,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <limits>
+
 #include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 /*
@@ -18,6 +22,17 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
     : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()) {
+  BUSTUB_ENSURE(!GetMetadata()->IsUnique() || GetMetadata()->GetIncludedColumnCount() == 0,
+                "included columns would take part in the uniqueness of the keys");
+  if (!GetMetadata()->IsUnique()) {
+    // The key columns must not run into the RID suffix.
+    size_t key_size = 0;
+    for (const auto &column : GetKeySchema()->GetColumns()) {
+      BUSTUB_ENSURE(column.IsInlined(), "non-unique indexes need fixed-length key columns");
+      key_size += column.GetFixedLength();
+    }
+    BUSTUB_ENSURE(key_size + KeyType::RID_SUFFIX_SIZE <= sizeof(KeyType), "key too large for a non-unique index");
+  }
   page_id_t header_page_id;
   buffer_pool_manager->NewPage(&header_page_id);
   container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(GetMetadata()->GetName(), header_page_id,
@@ -25,30 +40,81 @@ BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
-  // construct insert index key
+auto BPLUSTREE_INDEX_TYPE::MakeKey(const Tuple &key, RID rid) const -> KeyType {
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, *GetKeySchema());
+  // Keys too small for a RID suffix are refused by non-unique indexes on construction.
+  if constexpr (sizeof(KeyType) >= KeyType::RID_SUFFIX_SIZE) {
+    if (!GetMetadata()->IsUnique()) {
+      index_key.SetRid(rid);
+    }
+  }
+  return index_key;
+}
 
-  return container_->Insert(index_key, rid, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MakeBoundKey(const std::vector<Value> &prefix, bool fill_high) const -> KeyType {
+  const Schema &key_schema = *GetKeySchema();
+  std::vector<Value> values = prefix;
+  for (auto i = static_cast<uint32_t>(prefix.size()); i < key_schema.GetColumnCount(); i++) {
+    TypeId type = key_schema.GetColumn(i).GetType();
+    values.push_back(fill_high ? Type::GetMaxValue(type) : ValueFactory::GetNullValueByType(type));
+  }
+  // The RIDs whose suffixes sort before and after those of all other RIDs.
+  RID rid = fill_high ? RID(std::numeric_limits<page_id_t>::max(), std::numeric_limits<uint32_t>::max())
+                      : RID(std::numeric_limits<page_id_t>::min(), 0);
+  return MakeKey(Tuple(values, &key_schema), rid);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
-  // construct delete index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+auto BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  return container_->Insert(MakeKey(key, rid), rid, transaction);
+}
 
-  container_->Remove(index_key, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_->Remove(MakeKey(key, rid), transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
-  // construct scan index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  if (GetMetadata()->IsUnique()) {
+    container_->GetValue(MakeKey(key, RID()), result, transaction);
+    return;
+  }
+  // Included columns are not part of the search key.
+  std::vector<Value> prefix;
+  for (uint32_t i = 0; i < GetMetadata()->GetSearchColumnCount(); i++) {
+    prefix.push_back(key.GetValue(GetKeySchema(), i));
+  }
+  KeyRangeScan<KeyType> scan;
+  scan.lower_ = MakeBoundKey(prefix, false);
+  scan.upper_ = MakeBoundKey(prefix, true);
+  while (container_->ScanRange(&scan, result)) {
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BulkLoad(std::vector<MappingType> entries, Transaction *transaction) -> bool {
+  auto less = [&](const MappingType &a, const MappingType &b) { return comparator_(a.first, b.first) < 0; };
+  auto equal = [&](const MappingType &a, const MappingType &b) { return comparator_(a.first, b.first) == 0; };
+  std::sort(entries.begin(), entries.end(), less);
+  if (std::adjacent_find(entries.begin(), entries.end(), equal) != entries.end()) {
+    return false;
+  }
+  bool loaded = container_->BulkLoad(entries, BULK_LOAD_FILL_FACTOR, transaction);
+  BUSTUB_ENSURE(loaded, "bulk loading into an index that is not empty");
+  return true;
+}
 
-  container_->GetValue(index_key, result, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::ScanRange(KeyRangeScan<KeyType> *scan, std::vector<RID> *result) -> bool {
+  return container_->ScanRange(scan, result);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::ScanRange(KeyRangeScan<KeyType> *scan, std::vector<MappingType> *result) -> bool {
+  return container_->ScanRange(scan, result);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
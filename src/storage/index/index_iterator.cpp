@@ -3,28 +3,71 @@
  */
 #include <cassert>
 
+#include "buffer/buffer_pool_manager.h"
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(const BPlusTree<KeyType, ValueType, KeyComparator> *tree, ReadPageGuard guard,
+                                  int index, std::optional<KeyType> high_key)
+    : tree_(tree), guard_(std::move(guard)), high_key_(high_key), page_id_(guard_.PageId()), index_(index) {
+  SkipExhaustedLeaves();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_id_ == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
+  assert(!IsEnd());
+  item_ = guard_.template As<LeafPage>()->ItemAt(index_);
+  return item_;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  assert(!IsEnd());
+  index_++;
+  SkipExhaustedLeaves();
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { throw std::runtime_error("unimplemented"); }
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  while (page_id_ != INVALID_PAGE_ID) {
+    auto *leaf = guard_.template As<LeafPage>();
+    if (index_ < leaf->GetSize()) {
+      return;
+    }
+    // Release the current leaf before latching the next one. Writers latch leaves left to right as well, but only
+    // while they hold the parent, and a reader that waited on the sibling while holding its left neighbour could
+    // deadlock against a merge that latched the neighbour through the parent. Without the latch the sibling pointer
+    // cannot be trusted, so descend again to the first key at or above the high key, as BPlusTree::ScanRange() does.
+    guard_.Drop();
+    page_id_ = INVALID_PAGE_ID;
+    index_ = 0;
+    if (!high_key_.has_value()) {
+      return;
+    }
+    KeyType key = *high_key_;
+    high_key_.reset();
+    std::optional<ReadPageGuard> guard = tree_->FindLeafRead(key, &high_key_);
+    if (!guard.has_value()) {
+      return;
+    }
+    guard_ = std::move(*guard);
+    page_id_ = guard_.PageId();
+    index_ = guard_.template As<LeafPage>()->KeyIndex(key, tree_->comparator_);
+  }
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -9,6 +9,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -24,27 +26,234 @@ namespace bustub {
  * Including set page type, set current size, and set max page size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetMaxSize(max_size);
+  if constexpr (VARIABLE_LENGTH) {
+    Entries()->Init();
+  }
+}
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  KeyType key{};
-  return key;
+  if constexpr (VARIABLE_LENGTH) {
+    return Entries()->KeyAt(index);
+  }
+  return array_[index].first;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  if constexpr (VARIABLE_LENGTH) {
+    // The key may change its length, so the entry is stored again.
+    ValueType value = Entries()->ValueAt(index);
+    Entries()->RemoveAt(GetSize(), index);
+    Entries()->InsertAt(GetSize() - 1, index, key, value);
+  } else {
+    array_[index].first = key;
+  }
+}
+
+/*
+ * Helper method to find and return array index(or offset), so that its value
+ * equals to input "value"
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return -1;
+}
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return 0; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  if constexpr (VARIABLE_LENGTH) {
+    return Entries()->ValueAt(index);
+  }
+  return array_[index].second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  if constexpr (VARIABLE_LENGTH) {
+    Entries()->SetValueAt(index, value);
+  } else {
+    array_[index].second = value;
+  }
+}
+
+/*
+ * Binary search for the last key that is <= key, the first key is invalid and acts as minus infinity
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const -> int {
+  if constexpr (VARIABLE_LENGTH) {
+    return Entries()->Search(key, 1, GetSize(), true) - 1;
+  }
+  if constexpr (KeyAsWord<KeyType, KeyComparator>::ENABLED) {
+    // Branch-free upper bound over [1, size) on the keys as integers, see BPlusTreeLeafPage::KeyIndex().
+    using Word = KeyAsWord<KeyType, KeyComparator>;
+    auto word = Word::Get(key);
+    int size = GetSize() - 1;
+    if (size <= 0) {
+      return 0;
+    }
+    int base = 1;
+    while (size > 1) {
+      int half = size / 2;
+      base = Word::Get(array_[base + half].first) <= word ? base + half : base;
+      size -= half;
+    }
+    return base - 1 + static_cast<int>(Word::Get(array_[base].first) <= word);
+  }
+  int left = 1;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(array_[mid].first, key) <= 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left - 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsFull() const -> bool {
+  if constexpr (VARIABLE_LENGTH) {
+    return GetSize() >= GetMaxSize() || Entries()->UsedSize(GetSize()) + SlottedEntriesType::MAX_ENTRY_SIZE >
+                                            BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE;
+  }
+  return GetSize() >= GetMaxSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsUnderfull() const -> bool {
+  if constexpr (VARIABLE_LENGTH) {
+    return GetSize() < GetMinSize() && Entries()->UsedSize(GetSize()) < SlottedEntriesType::MIN_USED_SIZE;
+  }
+  return GetSize() < GetMinSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsSafeToRemove() const -> bool {
+  if constexpr (VARIABLE_LENGTH) {
+    return GetSize() > GetMinSize() ||
+           Entries()->UsedSize(GetSize()) >= SlottedEntriesType::MIN_USED_SIZE + SlottedEntriesType::MAX_ENTRY_SIZE;
+  }
+  return GetSize() > GetMinSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanSetKeyAt(int index, const KeyType &key) const -> bool {
+  if constexpr (VARIABLE_LENGTH) {
+    size_t old_length = SlottedEntriesType::Length(KeyAt(index));
+    return Entries()->UsedSize(GetSize()) - old_length + SlottedEntriesType::Length(key) <=
+           BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE;
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanAbsorb(const BPlusTreeInternalPage *right, const KeyType &separator) const
+    -> bool {
+  if (GetSize() + right->GetSize() > GetMaxSize()) {
+    return false;
+  }
+  if constexpr (VARIABLE_LENGTH) {
+    // Without a prefix the entries keep their sizes, except for the first one of right, which takes the separator
+    // once it has been moved.
+    size_t first_length = SlottedEntriesType::Length(right->KeyAt(0));
+    size_t used = Entries()->UsedSize(GetSize()) + right->Entries()->UsedSize(right->GetSize()) -
+                  SlottedEntriesType::HEADER_SIZE - first_length +
+                  std::max(first_length, SlottedEntriesType::Length(separator));
+    return used <= BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE;
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::SplitPoint(const std::vector<MappingType> &items) const -> int {
+  if constexpr (VARIABLE_LENGTH) {
+    return SlottedEntriesType::SplitPoint(items, 2, GetMaxSize());
+  }
+  return static_cast<int>(items.size()) / 2;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::BulkLoadSizes(const std::vector<MappingType> &items, int max_size,
+                                                   double fill_factor) -> std::vector<int> {
+  if constexpr (VARIABLE_LENGTH) {
+    return SlottedEntriesType::BulkLoadSizes(items, 2, max_size, fill_factor);
+  }
+  return BulkLoadNodeSizes(static_cast<int>(items.size()), max_size, (max_size + 1) / 2, fill_factor);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ShortestSeparator(const KeyType &left, const KeyType &right) -> KeyType {
+  if constexpr (VARIABLE_LENGTH) {
+    // The first byte where right differs from left is greater, and zeros in place of the rest sort no higher.
+    size_t length = SlottedEntriesType::CommonPrefix(left, right) + 1;
+    KeyType separator;
+    memset(separator.data_, 0, sizeof(separator.data_));
+    memcpy(separator.data_, right.data_, length);
+    return separator;
+  }
+  return right;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  BUSTUB_ASSERT(GetSize() < GetMaxSize(), "internal page is full");
+  if constexpr (VARIABLE_LENGTH) {
+    Entries()->InsertAt(GetSize(), index, key, value);
+  } else {
+    std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+    array_[index] = {key, value};
+  }
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAt(int index) {
+  if constexpr (VARIABLE_LENGTH) {
+    Entries()->RemoveAt(GetSize(), index);
+  } else {
+    std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+  }
+  IncreaseSize(-1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveSuffixTo(int index, BPlusTreeInternalPage *recipient) {
+  int count = GetSize() - index;
+  BUSTUB_ASSERT(recipient->GetSize() + count <= recipient->GetMaxSize(), "recipient is too small");
+  if constexpr (VARIABLE_LENGTH) {
+    std::vector<MappingType> items = Entries()->Entries(GetSize());
+    for (int i = index; i < GetSize(); i++) {
+      recipient->Entries()->InsertAt(recipient->GetSize() + i - index, recipient->GetSize() + i - index,
+                                     items[i].first, items[i].second);
+    }
+    items.resize(index);
+    Entries()->Rebuild(items);
+  } else {
+    std::copy(array_ + index, array_ + GetSize(), recipient->array_ + recipient->GetSize());
+  }
+  recipient->IncreaseSize(count);
+  SetSize(index);
+}
 
 // valuetype for internalNode should be page id_t
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
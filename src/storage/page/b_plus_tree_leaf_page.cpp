@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
 
 #include "common/exception.h"
@@ -26,16 +27,24 @@ namespace bustub {
  * Including set page type, set current size to zero, set next page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(int max_size) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(int max_size) {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetSize(0);
+  SetMaxSize(max_size);
+  next_page_id_ = INVALID_PAGE_ID;
+  if constexpr (VARIABLE_LENGTH) {
+    Entries()->Init();
+  }
+}
 
 /**
  * Helper methods to set/get next page id
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return INVALID_PAGE_ID; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
@@ -43,9 +52,170 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {}
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  KeyType key{};
-  return key;
+  if constexpr (VARIABLE_LENGTH) {
+    return Entries()->KeyAt(index);
+  }
+  return array_[index].first;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  if constexpr (VARIABLE_LENGTH) {
+    return Entries()->ValueAt(index);
+  }
+  return array_[index].second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ItemAt(int index) const -> MappingType {
+  if constexpr (VARIABLE_LENGTH) {
+    return {Entries()->KeyAt(index), Entries()->ValueAt(index)};
+  }
+  return array_[index];
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  if constexpr (VARIABLE_LENGTH) {
+    return Entries()->Search(key, 0, GetSize(), false);
+  }
+  if constexpr (KeyAsWord<KeyType, KeyComparator>::ENABLED) {
+    // Branch-free lower bound on the keys as integers: the trip count only depends on the size and the compiler
+    // turns the select into a conditional move, so no probe costs a mispredicted branch.
+    using Word = KeyAsWord<KeyType, KeyComparator>;
+    auto word = Word::Get(key);
+    int size = GetSize();
+    if (size == 0) {
+      return 0;
+    }
+    int base = 0;
+    while (size > 1) {
+      int half = size / 2;
+      base = Word::Get(array_[base + half].first) < word ? base + half : base;
+      size -= half;
+    }
+    return base + static_cast<int>(Word::Get(array_[base].first) < word);
+  }
+  int left = 0;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(array_[mid].first, key) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(const KeyType &key) const -> bool {
+  if constexpr (VARIABLE_LENGTH) {
+    return GetSize() < GetMaxSize() &&
+           Entries()->UsedSizeWith(GetSize(), key) <= BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE;
+  }
+  return GetSize() < GetMaxSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsUnderfull() const -> bool {
+  if constexpr (VARIABLE_LENGTH) {
+    return GetSize() < GetMinSize() && Entries()->UsedSize(GetSize()) < SlottedEntriesType::MIN_USED_SIZE;
+  }
+  return GetSize() < GetMinSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsSafeToRemove() const -> bool {
+  if constexpr (VARIABLE_LENGTH) {
+    return GetSize() > GetMinSize() ||
+           Entries()->UsedSize(GetSize()) >= SlottedEntriesType::MIN_USED_SIZE + SlottedEntriesType::MAX_ENTRY_SIZE;
+  }
+  return GetSize() > GetMinSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsBelowMergeThreshold(double merge_threshold) const -> bool {
+  int threshold = std::clamp(static_cast<int>(merge_threshold * GetMaxSize()), 1, std::max(GetMinSize(), 1));
+  if constexpr (VARIABLE_LENGTH) {
+    auto used_threshold = std::min(static_cast<size_t>(merge_threshold * (BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE)),
+                                   SlottedEntriesType::MIN_USED_SIZE);
+    return GetSize() == 0 || (GetSize() < threshold && Entries()->UsedSize(GetSize()) < used_threshold);
+  }
+  return GetSize() < threshold;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanAbsorb(const BPlusTreeLeafPage *right) const -> bool {
+  if (GetSize() + right->GetSize() > GetMaxSize()) {
+    return false;
+  }
+  if constexpr (VARIABLE_LENGTH) {
+    std::vector<MappingType> items = Entries()->Entries(GetSize());
+    std::vector<MappingType> right_items = right->Entries()->Entries(right->GetSize());
+    items.insert(items.end(), right_items.begin(), right_items.end());
+    return SlottedEntriesType::Size(items.data(), items.size()) <= BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE;
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::SplitPoint(const std::vector<MappingType> &items) const -> int {
+  if constexpr (VARIABLE_LENGTH) {
+    return SlottedEntriesType::SplitPoint(items, 1, GetMaxSize());
+  }
+  return static_cast<int>(items.size()) / 2;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::BulkLoadSizes(const std::vector<MappingType> &items, int max_size,
+                                               double fill_factor) -> std::vector<int> {
+  if constexpr (VARIABLE_LENGTH) {
+    return SlottedEntriesType::BulkLoadSizes(items, 1, max_size, fill_factor);
+  }
+  return BulkLoadNodeSizes(static_cast<int>(items.size()), max_size, max_size / 2, fill_factor);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  BUSTUB_ASSERT(GetSize() < GetMaxSize(), "leaf page is full");
+  if constexpr (VARIABLE_LENGTH) {
+    Entries()->InsertAt(GetSize(), index, key, value);
+  } else {
+    std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+    array_[index] = {key, value};
+  }
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAt(int index) {
+  if constexpr (VARIABLE_LENGTH) {
+    Entries()->RemoveAt(GetSize(), index);
+  } else {
+    std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+  }
+  IncreaseSize(-1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveSuffixTo(int index, BPlusTreeLeafPage *recipient) {
+  int count = GetSize() - index;
+  BUSTUB_ASSERT(recipient->GetSize() + count <= recipient->GetMaxSize(), "recipient is too small");
+  if constexpr (VARIABLE_LENGTH) {
+    // Both pages are written again, so that each gets the prefix of the entries it is left with.
+    std::vector<MappingType> items = Entries()->Entries(GetSize());
+    std::vector<MappingType> recipient_items = recipient->Entries()->Entries(recipient->GetSize());
+    recipient_items.insert(recipient_items.end(), items.begin() + index, items.end());
+    items.resize(index);
+    recipient->Entries()->Rebuild(recipient_items);
+    Entries()->Rebuild(items);
+  } else {
+    std::copy(array_ + index, array_ + GetSize(), recipient->array_ + recipient->GetSize());
+  }
+  recipient->IncreaseSize(count);
+  SetSize(index);
 }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
@@ -9,6 +9,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
@@ -17,27 +19,50 @@ namespace bustub {
  * Helper methods to get/set page type
  * Page type enum class is defined in b_plus_tree_page.h
  */
-auto BPlusTreePage::IsLeafPage() const -> bool { return false; }
-void BPlusTreePage::SetPageType(IndexPageType page_type) {}
+auto BPlusTreePage::IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
+void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
 
 /*
  * Helper methods to get/set size (number of key/value pairs stored in that
  * page)
  */
-auto BPlusTreePage::GetSize() const -> int { return 0; }
-void BPlusTreePage::SetSize(int size) {}
-void BPlusTreePage::IncreaseSize(int amount) {}
+auto BPlusTreePage::GetSize() const -> int { return size_; }
+void BPlusTreePage::SetSize(int size) { size_ = size; }
+void BPlusTreePage::IncreaseSize(int amount) { size_ += amount; }
 
 /*
  * Helper methods to get/set max size (capacity) of the page
  */
-auto BPlusTreePage::GetMaxSize() const -> int { return 0; }
-void BPlusTreePage::SetMaxSize(int size) {}
+auto BPlusTreePage::GetMaxSize() const -> int { return max_size_; }
+void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
 
 /*
  * Helper method to get min page size
  * Generally, min page size == max page size / 2
+ * An internal page counts its children, so it rounds up to keep at least two of them.
  */
-auto BPlusTreePage::GetMinSize() const -> int { return 0; }
+auto BPlusTreePage::GetMinSize() const -> int { return IsLeafPage() ? max_size_ / 2 : (max_size_ + 1) / 2; }
+
+auto BPlusTreePage::BulkLoadNodeSizes(int count, int max_size, int min_size, double fill_factor) -> std::vector<int> {
+  // At least two entries per node, or an internal level would not get any smaller than the one below it.
+  int lowest_target = std::min(std::max(min_size, 2), max_size);
+  int target = std::clamp(static_cast<int>(max_size * fill_factor), lowest_target, max_size);
+  std::vector<int> sizes(count / target, target);
+  int rest = count % target;
+  if (rest == 0) {
+    return sizes;
+  }
+  if (sizes.empty() || rest >= min_size) {
+    sizes.push_back(rest);
+  } else if (sizes.back() + rest <= max_size) {
+    sizes.back() += rest;
+  } else {
+    // More than max_size entries are left for the last two nodes, so both halves reach the minimum size.
+    int total = sizes.back() + rest;
+    sizes.back() = total - total / 2;
+    sizes.push_back(total / 2);
+  }
+  return sizes;
+}
 
 }  // namespace bustub
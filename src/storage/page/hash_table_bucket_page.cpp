@@ -10,6 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <iterator>
+#include <optional>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "storage/page/hash_table_bucket_page.h"
 #include "common/logger.h"
 #include "common/util/hash_util.h"
@@ -20,62 +28,151 @@
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::MatchFingerprint(uint32_t group, uint8_t fingerprint) const -> uint32_t {
+#if defined(__SSE2__)
+  __m128i needle = _mm_set1_epi8(static_cast<char>(fingerprint));
+  __m128i slots = _mm_loadu_si128(reinterpret_cast<const __m128i *>(fingerprints_ + group * 16));
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(slots, needle)));
+#else
+  uint32_t matches = 0;
+  for (uint32_t i = 0; i < 16; i++) {
+    matches |= static_cast<uint32_t>(fingerprints_[group * 16 + i] == fingerprint) << i;
+  }
+  return matches;
+#endif
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
-  return true;
+auto HASH_TABLE_BUCKET_TYPE::GroupBits(const char *bitmap, uint32_t group) -> uint32_t {
+  auto low = static_cast<uint8_t>(bitmap[group * 2]);
+  auto high = static_cast<uint8_t>(bitmap[group * 2 + 1]);
+  return low | static_cast<uint32_t>(high) << 8;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::FindSlot(uint32_t start, const KeyType &key, const ValueType *value, uint8_t fingerprint,
+                                      KeyComparator cmp) const -> std::optional<uint32_t> {
+  for (uint32_t group = start / 16; group < BUCKET_SLOT_GROUPS; group++) {
+    // Slots before start in its group are masked off, as are the ones that only held an entry once.
+    uint32_t candidates = MatchFingerprint(group, fingerprint) & GroupBits(readable_, group);
+    if (group == start / 16) {
+      candidates &= ~((1U << (start % 16)) - 1);
+    }
+    while (candidates != 0) {
+      uint32_t bucket_idx = group * 16 + __builtin_ctz(candidates);
+      candidates &= candidates - 1;
+      if (cmp(array_[bucket_idx].first, key) == 0 && (value == nullptr || array_[bucket_idx].second == *value)) {
+        return bucket_idx;
+      }
+    }
+    // Slots are taken in order and never freed, only made unreadable, so the first unoccupied slot ends the bucket.
+    if (GroupBits(occupied_, group) != 0xFFFF) {
+      break;
+    }
+  }
+  return std::nullopt;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, uint32_t hash, KeyComparator cmp,
+                                      std::vector<ValueType> *result) const -> bool {
+  bool found = false;
+  uint8_t fingerprint = Fingerprint(hash);
+  for (auto bucket_idx = FindSlot(0, key, nullptr, fingerprint, cmp); bucket_idx.has_value();
+       bucket_idx = FindSlot(*bucket_idx + 1, key, nullptr, fingerprint, cmp)) {
+    result->push_back(array_[*bucket_idx].second);
+    found = true;
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, uint32_t hash, KeyComparator cmp) -> bool {
+  uint8_t fingerprint = Fingerprint(hash);
+  if (FindSlot(0, key, &value, fingerprint, cmp).has_value()) {
+    return false;
+  }
+  // Tombstones are reused first, so that the occupied slots stay a prefix of the bucket.
+  for (uint32_t group = 0; group < BUCKET_SLOT_GROUPS; group++) {
+    uint32_t free_slots = ~GroupBits(readable_, group) & 0xFFFF;
+    if (free_slots == 0) {
+      continue;
+    }
+    uint32_t bucket_idx = group * 16 + __builtin_ctz(free_slots);
+    if (bucket_idx >= BUCKET_ARRAY_SIZE) {
+      break;
+    }
+    array_[bucket_idx] = MappingType(key, value);
+    fingerprints_[bucket_idx] = fingerprint;
+    SetOccupied(bucket_idx);
+    SetReadable(bucket_idx);
+    return true;
+  }
   return false;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, uint32_t hash, KeyComparator cmp) -> bool {
+  auto bucket_idx = FindSlot(0, key, &value, Fingerprint(hash), cmp);
+  if (!bucket_idx.has_value()) {
+    return false;
+  }
+  RemoveAt(*bucket_idx);
+  return true;
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const -> KeyType {
-  return {};
+  return array_[bucket_idx].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const -> ValueType {
-  return {};
+  return array_[bucket_idx].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] &= static_cast<char>(~(1 << (bucket_idx % 8)));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsOccupied(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (occupied_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {
+  occupied_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsReadable(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (readable_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::IsFull() -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::IsFull() const -> bool {
+  return NumReadable() == BUCKET_ARRAY_SIZE;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::NumReadable() -> uint32_t {
-  return 0;
+auto HASH_TABLE_BUCKET_TYPE::NumReadable() const -> uint32_t {
+  uint32_t count = 0;
+  for (char bits : readable_) {
+    count += __builtin_popcount(static_cast<unsigned char>(bits));
+  }
+  return count;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::IsEmpty() -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::IsEmpty() const -> bool {
+  return std::all_of(std::begin(readable_), std::end(readable_), [](char bits) { return bits == 0; });
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
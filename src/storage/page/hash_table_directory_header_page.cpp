@@ -0,0 +1,43 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_header_page.cpp
+//
+// Identification: src/storage/page/hash_table_directory_header_page.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_directory_header_page.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace bustub {
+
+void HashTableDirectoryHeaderPage::Init(uint32_t max_depth) {
+  assert((1U << max_depth) <= DIRECTORY_HEADER_ARRAY_SIZE);
+  max_depth_ = max_depth;
+  std::fill(directory_page_ids_, directory_page_ids_ + DIRECTORY_HEADER_ARRAY_SIZE, INVALID_PAGE_ID);
+}
+
+auto HashTableDirectoryHeaderPage::HashToDirectoryIndex(uint32_t hash) const -> uint32_t {
+  // Directories index buckets by the low bits of the hash, so the header uses the high ones.
+  return max_depth_ == 0 ? 0 : hash >> (32 - max_depth_);
+}
+
+auto HashTableDirectoryHeaderPage::GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t {
+  return directory_page_ids_[directory_idx];
+}
+
+void HashTableDirectoryHeaderPage::SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id) {
+  directory_page_ids_[directory_idx] = directory_page_id;
+}
+
+auto HashTableDirectoryHeaderPage::MaxSize() const -> uint32_t { return 1U << max_depth_; }
+
+auto HashTableDirectoryHeaderPage::GetMaxDepth() const -> uint32_t { return max_depth_; }
+
+}  // namespace bustub
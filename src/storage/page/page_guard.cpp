@@ -3,58 +3,77 @@
 
 namespace bustub {
 
-BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept {
-  this->is_dirty_ = that.is_dirty_;
-  this->bpm_ = that.bpm_;
-  this->page_ = that.page_;
-  this->is_own_page_ = that.is_own_page_;
-  that.is_own_page_ = false;
+BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept
+    : bpm_(that.bpm_), page_(that.page_), is_dirty_(that.is_dirty_) {
+  that.bpm_ = nullptr;
+  that.page_ = nullptr;
+  that.is_dirty_ = false;
 }
 
 void BasicPageGuard::Drop() {
-  // clear memory
-  memset(page_->GetData(), 0, BUSTUB_PAGE_SIZE);
-  this->bpm_->UnpinPage(this->page_->GetPageId(), this->is_dirty_);
+  if (bpm_ != nullptr && page_ != nullptr) {
+    bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
+  }
+  bpm_ = nullptr;
+  page_ = nullptr;
+  is_dirty_ = false;
 }
 
 auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard & {
-  this->bpm_->UnpinPage(this->page_->GetPageId(), this->is_dirty_);
-  this->is_dirty_ = that.is_dirty_;
-  this->bpm_ = that.bpm_;
-  this->page_ = that.page_;
-  this->is_own_page_ = that.is_own_page_;
-  that.is_own_page_ = false;
+  if (this == &that) {
+    return *this;
+  }
+  Drop();
+  bpm_ = that.bpm_;
+  page_ = that.page_;
+  is_dirty_ = that.is_dirty_;
+  that.bpm_ = nullptr;
+  that.page_ = nullptr;
+  that.is_dirty_ = false;
   return *this;
 }
 
-BasicPageGuard::~BasicPageGuard() {
-  if (this->is_own_page_) {
-    this->bpm_->UnpinPage(this->page_->GetPageId(), this->is_dirty_);
-  }
-};  // NOLINT
+BasicPageGuard::~BasicPageGuard() { Drop(); };  // NOLINT
 
-ReadPageGuard::ReadPageGuard(ReadPageGuard &&that) noexcept { this->guard_ = BasicPageGuard(std::move(that.guard_)); }
+ReadPageGuard::ReadPageGuard(ReadPageGuard &&that) noexcept : guard_(std::move(that.guard_)) {}
 
 auto ReadPageGuard::operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard & {
-  this->guard_ = std::move(that.guard_);
+  if (this == &that) {
+    return *this;
+  }
+  Drop();
+  guard_ = std::move(that.guard_);
   return *this;
 }
 
-void ReadPageGuard::Drop() { this->guard_.Drop(); }
+void ReadPageGuard::Drop() {
+  // release the latch before unpinning, otherwise the frame could be reused while we still hold its latch
+  if (guard_.page_ != nullptr) {
+    guard_.page_->RUnlatch();
+  }
+  guard_.Drop();
+}
 
-ReadPageGuard::~ReadPageGuard() {}  // NOLINT
+ReadPageGuard::~ReadPageGuard() { Drop(); }  // NOLINT
 
-WritePageGuard::WritePageGuard(WritePageGuard &&that) noexcept {
-  this->guard_ = BasicPageGuard(std::move(that.guard_));
-}
+WritePageGuard::WritePageGuard(WritePageGuard &&that) noexcept : guard_(std::move(that.guard_)) {}
 
 auto WritePageGuard::operator=(WritePageGuard &&that) noexcept -> WritePageGuard & {
-  this->guard_ = std::move(that.guard_);
+  if (this == &that) {
+    return *this;
+  }
+  Drop();
+  guard_ = std::move(that.guard_);
   return *this;
 }
 
-void WritePageGuard::Drop() { this->guard_.Drop(); }
+void WritePageGuard::Drop() {
+  if (guard_.page_ != nullptr) {
+    guard_.page_->WUnlatch();
+  }
+  guard_.Drop();
+}
 
-WritePageGuard::~WritePageGuard() {}  // NOLINT
+WritePageGuard::~WritePageGuard() { Drop(); }  // NOLINT
 
 }  // namespace bustub
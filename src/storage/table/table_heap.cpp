@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 #include <mutex>  // NOLINT
 #include <utility>
@@ -30,6 +31,7 @@ TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
   // Initialize the first table page.
   auto guard = bpm->NewPageGuarded(&first_page_id_);
   last_page_id_ = first_page_id_;
+  page_ids_.push_back(first_page_id_);
   auto first_page = guard.AsMut<TablePage>();
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
@@ -65,6 +67,7 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
     auto next_page_guard = WritePageGuard{bpm_, npg};
 
     last_page_id_ = next_page_id;
+    page_ids_.push_back(next_page_id);
     page_guard = std::move(next_page_guard);
   }
   auto last_page_id = last_page_id_;
@@ -91,8 +94,8 @@ void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   page->UpdateTupleMeta(meta, rid);
 }
 
-auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
-  auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+auto TableHeap::GetTuple(RID rid, AccessType access_type) -> std::pair<TupleMeta, Tuple> {
+  auto page_guard = bpm_->FetchPageRead(rid.GetPageId(), access_type);
   auto page = page_guard.As<TablePage>();
   auto [meta, tuple] = page->GetTuple(rid);
   tuple.rid_ = rid;
@@ -117,6 +120,22 @@ auto TableHeap::MakeIterator() -> TableIterator {
 
 auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}}; }
 
+auto TableHeap::GetPageIds(size_t begin, size_t end) -> std::vector<page_id_t> {
+  std::scoped_lock<std::mutex> guard(latch_);
+  end = std::min(end, page_ids_.size());
+  if (begin >= end) {
+    return {};
+  }
+  return {page_ids_.begin() + begin, page_ids_.begin() + end};
+}
+
+auto TableHeap::GetPageIndex(page_id_t page_id) -> size_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto it = std::find(page_ids_.begin(), page_ids_.end(), page_id);
+  BUSTUB_ASSERT(it != page_ids_.end(), "page does not belong to this table");
+  return it - page_ids_.begin();
+}
+
 void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
   auto page = page_guard.AsMut<TablePage>();
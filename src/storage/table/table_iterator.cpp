@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 #include <optional>
 
 #include "common/config.h"
@@ -21,32 +23,49 @@
 namespace bustub {
 
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
-    : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
+    : table_heap_(table_heap),
+      rid_(rid),
+      strategy_(std::make_unique<BufferAccessStrategy>()),
+      stop_at_rid_(stop_at_rid) {
   // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
   // we set rid_ to invalid.
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan, strategy_.get());
   auto page = page_guard.As<TablePage>();
   if (rid_.GetSlotNum() >= page->GetNumTuples()) {
     rid_ = RID{INVALID_PAGE_ID, 0};
+    return;
   }
+  page_guard.Drop();
+
+  // the current page and the window have to fit into the scan's ring, otherwise prefetched pages would recycle each
+  // other before they are scanned; pages need not be spread evenly over parallel instances, so any one ring must do
+  size_t ring_size = table_heap_->bpm_->GetScanRingSize();
+  read_ahead_pages_ = ring_size == 0 ? 0 : std::min<size_t>(READ_AHEAD_PAGES, ring_size - 1);
+  page_index_ = table_heap_->GetPageIndex(rid_.GetPageId());
+  if (stop_at_rid_.GetPageId() != INVALID_PAGE_ID) {
+    stop_page_index_ = table_heap_->GetPageIndex(stop_at_rid_.GetPageId());
+  }
+  read_ahead_end_ = page_index_ + 1;
+  ReadAhead();
 }
 
-auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
+auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_, AccessType::Scan); }
 
 auto TableIterator::GetRID() -> RID { return rid_; }
 
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
 
 auto TableIterator::operator++() -> TableIterator & {
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan, strategy_.get());
   auto page = page_guard.As<TablePage>();
   auto next_tuple_id = rid_.GetSlotNum() + 1;
 
   if (stop_at_rid_.GetPageId() != INVALID_PAGE_ID) {
+    // page ids need not grow along the chain once freed pages are reused, so compare positions in it
     BUSTUB_ASSERT(
-        /* case 1: cursor before the page of the stop tuple */ rid_.GetPageId() < stop_at_rid_.GetPageId() ||
+        /* case 1: cursor before the page of the stop tuple */ page_index_ < stop_page_index_ ||
             /* case 2: cursor at the page before the tuple */
-            (rid_.GetPageId() == stop_at_rid_.GetPageId() && next_tuple_id <= stop_at_rid_.GetSlotNum()),
+            (page_index_ == stop_page_index_ && next_tuple_id <= stop_at_rid_.GetSlotNum()),
         "iterate out of bound");
   }
 
@@ -60,11 +79,33 @@ auto TableIterator::operator++() -> TableIterator & {
     auto next_page_id = page->GetNextPageId();
     // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
     rid_ = RID{next_page_id, 0};
+    if (next_page_id != INVALID_PAGE_ID) {
+      page_index_++;
+    }
   }
 
   page_guard.Drop();
 
+  if (!IsEnd()) {
+    ReadAhead();
+  }
+
   return *this;
 }
 
+void TableIterator::ReadAhead() {
+  size_t end = page_index_ + 1 + read_ahead_pages_;
+  if (read_ahead_end_ >= end) {
+    return;
+  }
+  for (page_id_t page_id : table_heap_->GetPageIds(read_ahead_end_, end)) {
+    if (read_ahead_end_ > stop_page_index_) {
+      // pages appended after the iterator was created are never scanned
+      return;
+    }
+    table_heap_->bpm_->PrefetchPage(page_id, strategy_.get());
+    read_ahead_end_++;
+  }
+}
+
 }  // namespace bustub
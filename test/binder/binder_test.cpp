@@ -13,6 +13,7 @@
 #include "binder/binder.h"
 #include <memory>
 #include "binder/bound_statement.h"
+#include "binder/statement/index_statement.h"
 #include "catalog/catalog.h"
 #include "gtest/gtest.h"
 
@@ -143,6 +144,18 @@ TEST(BinderTest, FailBindUnknownColumn) {
 
 TEST(BinderTest, BindCreateTable) { TryBind("CREATE TABLE tablex (v1 int)"); }
 
+TEST(BinderTest, BindCreateIndex) {
+  auto statements = TryBind("CREATE INDEX ix ON y (x) WITH (include = z)");
+  ASSERT_FALSE(dynamic_cast<const IndexStatement &>(*statements[0]).is_unique_);
+  statements = TryBind("CREATE UNIQUE INDEX ix ON y (x, z)");
+  ASSERT_TRUE(dynamic_cast<const IndexStatement &>(*statements[0]).is_unique_);
+  PrintStatements(statements);
+}
+
+TEST(BinderTest, FailBindUniqueIndexWithInclude) {
+  EXPECT_THROW(TryBind("CREATE UNIQUE INDEX ix ON y (x) WITH (include = z)"), Exception);
+}
+
 TEST(BinderTest, BindInsert) { TryBind("INSERT INTO y VALUES (1,2,3,4,5), (6,7,8,9,10)"); }
 
 TEST(BinderTest, BindInsertSelect) { TryBind("INSERT INTO y SELECT * FROM y WHERE x < 500"); }
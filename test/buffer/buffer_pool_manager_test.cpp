@@ -12,16 +12,42 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "common/exception.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
+/** Counts the pages read from and written to disk, and fails every read and write while fail_io_ is set. */
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    reads_++;
+    if (fail_io_) {
+      throw Exception("injected read error");
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
 
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    writes_++;
+    if (fail_io_) {
+      throw Exception("injected write error");
+    }
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
 
+  std::atomic<size_t> reads_{0};
+  std::atomic<size_t> writes_{0};
+  std::atomic<bool> fail_io_{false};
+};
 
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
@@ -215,4 +241,439 @@ TEST(BufferPoolManagerTest, NewFetch) {
 }
 
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ScanResistanceTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t hot_pages = 8;
+  const size_t total_pages = 200;
+
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  page_id_t page_id;
+  for (size_t i = 0; i < total_pages; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: warm up the hot pages with point lookups.
+  for (int round = 0; round < 2; round++) {
+    for (size_t i = 0; i < hot_pages; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i, AccessType::Get));
+      ASSERT_TRUE(bpm->UnpinPage(i, false, AccessType::Get));
+    }
+  }
+
+  // Scenario: a full scan over the remaining pages only recycles its ring.
+  BufferAccessStrategy strategy;
+  for (size_t i = hot_pages; i < total_pages; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i, AccessType::Scan, &strategy));
+    ASSERT_TRUE(bpm->UnpinPage(i, false, AccessType::Scan));
+  }
+
+  // Scenario: the hot pages are still cached after the scan.
+  size_t reads = disk_manager->reads_;
+  for (size_t i = 0; i < hot_pages; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i, AccessType::Get));
+    ASSERT_TRUE(bpm->UnpinPage(i, false, AccessType::Get));
+  }
+  EXPECT_EQ(reads, disk_manager->reads_);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ScanRingReclaimTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t ring_size = buffer_pool_size / 4;
+
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  page_id_t page_id;
+  for (size_t i = 0; i < 2 * buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: a finished scan leaves its pages in the ring, unpinned.
+  BufferAccessStrategy strategy;
+  for (size_t i = 0; i < ring_size; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i, AccessType::Scan, &strategy));
+    ASSERT_TRUE(bpm->UnpinPage(i, false, AccessType::Scan));
+  }
+
+  // Scenario: every frame outside the ring is pinned.
+  for (size_t i = ring_size; i < buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i, AccessType::Get));
+  }
+
+  // Scenario: the ring frames are handed out once nothing else is left, and only then does the pool run out.
+  for (size_t i = 0; i < ring_size; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id)) << i;
+  }
+  ASSERT_EQ(nullptr, bpm->NewPage(&page_id));
+  ASSERT_EQ(nullptr, bpm->FetchPage(buffer_pool_size, AccessType::Scan, &strategy));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ScanRingPerScanTest) {
+  const size_t buffer_pool_size = 32;
+  const size_t ring_size = buffer_pool_size / 4;
+  const size_t hot_pages = 8;
+  const size_t total_pages = 200;
+
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  page_id_t page_id;
+  for (size_t i = 0; i < total_pages; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (int round = 0; round < 2; round++) {
+    for (size_t i = 0; i < hot_pages; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i, AccessType::Get));
+      ASSERT_TRUE(bpm->UnpinPage(i, false, AccessType::Get));
+    }
+  }
+
+  // Scenario: two interleaved scans each keep their current page pinned while the other one misses, and the first
+  // scan also holds on to its first page, so the slot next in turn in its ring is pinned once the ring wraps around.
+  BufferAccessStrategy first;
+  BufferAccessStrategy second;
+  const page_id_t held = hot_pages;
+  ASSERT_NE(nullptr, bpm->FetchPage(held, AccessType::Scan, &first));
+  page_id_t first_current = held;
+  page_id_t second_current = INVALID_PAGE_ID;
+  for (page_id_t i = hot_pages + 1; i + 1 < static_cast<page_id_t>(total_pages); i += 2) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i, AccessType::Scan, &first));
+    if (first_current != held) {
+      ASSERT_TRUE(bpm->UnpinPage(first_current, false, AccessType::Scan));
+    }
+    first_current = i;
+    ASSERT_NE(nullptr, bpm->FetchPage(i + 1, AccessType::Scan, &second));
+    if (second_current != INVALID_PAGE_ID) {
+      ASSERT_TRUE(bpm->UnpinPage(second_current, false, AccessType::Scan));
+    }
+    second_current = i + 1;
+  }
+
+  // Scenario: the scans only recycled their own rings, so the hot pages and the held page are still cached.
+  size_t reads = disk_manager->reads_;
+  for (size_t i = 0; i < hot_pages; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i, AccessType::Get));
+    ASSERT_TRUE(bpm->UnpinPage(i, false, AccessType::Get));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(held, AccessType::Scan, &first));
+  EXPECT_EQ(reads, disk_manager->reads_);
+  EXPECT_TRUE(bpm->UnpinPage(held, false, AccessType::Scan));
+  EXPECT_TRUE(bpm->UnpinPage(held, false, AccessType::Scan));
+  EXPECT_TRUE(bpm->UnpinPage(first_current, false, AccessType::Scan));
+  EXPECT_TRUE(bpm->UnpinPage(second_current, false, AccessType::Scan));
+
+  // Scenario: once a scan is done, the frames of its ring can be evicted like any other unpinned page.
+  {
+    BufferAccessStrategy done;
+    for (size_t i = 0; i < ring_size; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i + hot_pages, AccessType::Scan, &done));
+      ASSERT_TRUE(bpm->UnpinPage(i + hot_pages, false, AccessType::Scan));
+    }
+  }
+  std::vector<page_id_t> pinned;
+  for (size_t i = 0; i < ring_size; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id)) << i;
+    pinned.push_back(page_id);
+  }
+  for (auto id : pinned) {
+    ASSERT_TRUE(bpm->UnpinPage(id, false));
+  }
+  // they were the coldest pages, so the new pages did not evict the hot ones
+  reads = disk_manager->reads_;
+  for (size_t i = 0; i < hot_pages; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i, AccessType::Get));
+    ASSERT_TRUE(bpm->UnpinPage(i, false, AccessType::Get));
+  }
+  EXPECT_EQ(reads, disk_manager->reads_);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundFlusherTest) {
+  const size_t buffer_pool_size = 20;
+
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+  // Scenario: starting the flusher with the whole pool dirty makes it clean the cold end down to the low watermark.
+  page_id_t page_id;
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  bpm->StartBackgroundFlusher(0.5, 0.25);
+  for (int i = 0; i < 1000 && disk_manager->writes_ < buffer_pool_size - buffer_pool_size / 4; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  // stopping waits for the flusher to finish its batch
+  bpm->StopBackgroundFlusher();
+  ASSERT_EQ(disk_manager->writes_, buffer_pool_size - buffer_pool_size / 4);
+
+  // Scenario: victims are now clean, so new pages evict without writing.
+  size_t writes = disk_manager->writes_;
+  std::vector<page_id_t> scan_page_ids;
+  for (size_t i = 0; i < buffer_pool_size / 2; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+    scan_page_ids.push_back(page_id);
+  }
+  EXPECT_EQ(writes, disk_manager->writes_);
+
+  // Scenario: pages written by the flusher read back intact.
+  for (auto id : page_ids) {
+    auto *page = bpm->FetchPage(id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(id)).c_str()));
+    ASSERT_TRUE(bpm->UnpinPage(id, false));
+  }
+
+  // Scenario: pages a scan dirties in its ring are written in the background even below the high watermark, so
+  // recycling the ring does not write on the scan's misses.
+  const size_t ring_size = bpm->GetScanRingSize();
+  ASSERT_LE(2 * ring_size, scan_page_ids.size());
+  bpm->FlushAllPages();
+  writes = disk_manager->writes_;
+  bpm->StartBackgroundFlusher(1, 1);
+  BufferAccessStrategy strategy;
+  for (size_t i = 0; i < ring_size; i++) {
+    auto *page = bpm->FetchPage(scan_page_ids[i], AccessType::Scan, &strategy);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "scanned %d", scan_page_ids[i]);
+    ASSERT_TRUE(bpm->UnpinPage(scan_page_ids[i], true, AccessType::Scan));
+  }
+  for (int i = 0; i < 1000 && disk_manager->writes_ < writes + ring_size; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(writes + ring_size, disk_manager->writes_);
+  for (size_t i = ring_size; i < 2 * ring_size; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(scan_page_ids[i], AccessType::Scan, &strategy));
+    ASSERT_TRUE(bpm->UnpinPage(scan_page_ids[i], false, AccessType::Scan));
+  }
+  EXPECT_EQ(writes + ring_size, disk_manager->writes_);
+  bpm->StopBackgroundFlusher();
+  for (size_t i = 0; i < ring_size; i++) {
+    auto guard = bpm->FetchPageRead(scan_page_ids[i]);
+    EXPECT_EQ("scanned " + std::to_string(scan_page_ids[i]), std::string(guard.As<char>()));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentHitTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t num_pages = 12;
+  const size_t num_threads = 4;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: hits race with the misses that replace their frames, every fetch must see the right page.
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&bpm, &page_ids, tid] {
+      std::mt19937 gen(tid);
+      // the first pages are hot, the rest keep causing evictions
+      std::uniform_int_distribution<size_t> hot_dist(0, 3);
+      std::uniform_int_distribution<size_t> any_dist(0, num_pages - 1);
+      for (int i = 0; i < 2000; i++) {
+        page_id_t page_id = page_ids[i % 2 == 0 ? hot_dist(gen) : any_dist(gen)];
+        // at most num_threads frames are pinned at a time, so the fetch always finds a frame
+        auto guard = bpm->FetchPageRead(page_id);
+        ASSERT_EQ(page_id, guard.PageId());
+        ASSERT_EQ("page " + std::to_string(page_id), std::string(guard.As<char>()));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Scenario: every pin was dropped, so every frame can be replaced again.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentMissTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t num_threads = 4;
+  const size_t latency_ms = 50;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  // Fill the disk with twice as many pages as fit in the pool, the first half is evicted.
+  page_id_t page_id;
+  for (size_t i = 0; i < 2 * buffer_pool_size; i++) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    ASSERT_TRUE(bpm->FlushPage(page_id));
+  }
+  disk_manager->SetLatency(latency_ms);
+
+  // Scenario: misses on different pages read them at the same time, not one after the other.
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&bpm, tid] {
+      auto page_id = static_cast<page_id_t>(tid);
+      auto guard = bpm->FetchPageRead(page_id);
+      EXPECT_EQ("page " + std::to_string(page_id), std::string(guard.As<char>()));
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  EXPECT_LT(elapsed.count(), num_threads * latency_ms * 3 / 4);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PageReuseTest) {
+  const size_t buffer_pool_size = 4;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 8; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_EQ(i, page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: deleted pages are handed out again, whether or not they were still in the pool.
+  EXPECT_TRUE(bpm->DeletePage(1));
+  EXPECT_TRUE(bpm->DeletePage(6));
+  EXPECT_EQ(2, disk_manager->GetFragmentation().num_free_pages_);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(1, page_id);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(6, page_id);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(8, page_id);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PrefetchTest) {
+  const size_t buffer_pool_size = 64;
+  const size_t num_prefetched = 4;
+  const size_t latency_ms = 50;
+
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  // Fill the disk with twice as many pages as fit in the pool, the first half is evicted.
+  page_id_t page_id;
+  for (size_t i = 0; i < 2 * buffer_pool_size; i++) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    ASSERT_TRUE(bpm->FlushPage(page_id));
+  }
+  disk_manager->SetLatency(latency_ms);
+  size_t reads = disk_manager->reads_;
+
+  // Scenario: prefetching returns right away and the reads overlap.
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_prefetched; i++) {
+    bpm->PrefetchPage(static_cast<page_id_t>(i));
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(latency_ms));
+
+  // Scenario: fetches wait for the prefetch of their page instead of reading it again.
+  for (size_t i = 0; i < num_prefetched; i++) {
+    auto guard = bpm->FetchPageRead(static_cast<page_id_t>(i));
+    EXPECT_EQ("page " + std::to_string(i), std::string(guard.As<char>()));
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  EXPECT_LT(elapsed.count(), num_prefetched * latency_ms * 3 / 4);
+  EXPECT_EQ(reads + num_prefetched, disk_manager->reads_);
+
+  // Scenario: prefetching a page that is in the pool does nothing, and prefetched pages are not pinned.
+  bpm->PrefetchPage(0);
+  EXPECT_EQ(reads + num_prefetched, disk_manager->reads_);
+  for (size_t i = 0; i < num_prefetched; i++) {
+    EXPECT_TRUE(bpm->DeletePage(static_cast<page_id_t>(i)));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, IOErrorTest) {
+  const size_t buffer_pool_size = 4;
+  const page_id_t num_pages = 8;
+
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+  page_id_t page_id;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  // the last buffer_pool_size pages are in the pool, all dirty
+  const page_id_t first_cached = num_pages - static_cast<page_id_t>(buffer_pool_size);
+  disk_manager->fail_io_ = true;
+
+  // Scenario: a miss whose victim cannot be written back throws, and so does a flush.
+  EXPECT_THROW(bpm->FetchPage(0), Exception);
+  EXPECT_THROW(bpm->FlushPage(first_cached), Exception);
+
+  // Scenario: the background flusher keeps pages it failed to write dirty.
+  size_t writes = disk_manager->writes_;
+  bpm->StartBackgroundFlusher(0, 0);
+  for (int i = 0; i < 1000 && disk_manager->writes_ < writes + buffer_pool_size; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bpm->StopBackgroundFlusher();
+
+  // Scenario: once the victims are clean, a miss whose read fails throws, whether or not a prefetch failed first.
+  disk_manager->fail_io_ = false;
+  ASSERT_TRUE(bpm->FlushPage(first_cached));
+  ASSERT_TRUE(bpm->FlushPage(first_cached + 1));
+  disk_manager->fail_io_ = true;
+  EXPECT_THROW(bpm->FetchPage(0), Exception);
+  bpm->PrefetchPage(1);
+  EXPECT_THROW(bpm->FetchPage(1), Exception);
+
+  // Scenario: afterwards no frame is lost and no write is: the pool still holds buffer_pool_size pinned pages, and
+  // every page reads back what was written to it.
+  disk_manager->fail_io_ = false;
+  std::vector<Page *> pinned;
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); i++) {
+    pinned.push_back(bpm->FetchPage(i));
+    ASSERT_NE(nullptr, pinned.back());
+  }
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); i++) {
+    ASSERT_TRUE(bpm->UnpinPage(i, false));
+  }
+  for (page_id_t i = 0; i < num_pages; i++) {
+    auto guard = bpm->FetchPageRead(i);
+    EXPECT_EQ("page " + std::to_string(i), std::string(guard.As<char>()));
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, SampleTest) {
+  // large enough to try huge pages
+  const size_t num_frames = 2 * BUSTUB_HUGE_PAGE_SIZE / BUSTUB_PAGE_SIZE;
+  FrameArena arena(num_frames);
+
+  // Scenario: frames are page aligned, zeroed, and do not overlap.
+  char *prev = nullptr;
+  for (size_t i = 0; i < num_frames; i++) {
+    char *data = arena.FrameData(static_cast<frame_id_t>(i));
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(data) % BUSTUB_PAGE_SIZE);
+    ASSERT_EQ(0, data[0]);
+    ASSERT_EQ(0, data[BUSTUB_PAGE_SIZE - 1]);
+    if (prev != nullptr) {
+      ASSERT_GE(data - prev, BUSTUB_PAGE_SIZE);
+    }
+    memset(data, static_cast<int>(i % 128), BUSTUB_PAGE_SIZE);
+    prev = data;
+  }
+  for (size_t i = 0; i < num_frames; i++) {
+    char *data = arena.FrameData(static_cast<frame_id_t>(i));
+    ASSERT_EQ(static_cast<char>(i % 128), data[0]);
+    ASSERT_EQ(static_cast<char>(i % 128), data[BUSTUB_PAGE_SIZE - 1]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, BufferPoolLayoutTest) {
+  const size_t buffer_pool_size = 10;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  // Scenario: every frame is page aligned, and the metadata of two frames never shares a cache line.
+  Page *pages = bpm->GetPages();
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(pages[i].GetData()) % BUSTUB_PAGE_SIZE);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(&pages[i]) % BUSTUB_CACHE_LINE_SIZE);
+  }
+}
+
+}  // namespace bustub
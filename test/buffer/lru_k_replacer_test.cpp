@@ -96,4 +96,84 @@ TEST(LRUKReplacerTest, SampleTest) {
   ASSERT_EQ(false, lru_replacer.Evict(&value));
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, EvictionOrderTest) {
+  const size_t num_frames = 64;
+  const size_t k = 3;
+  LRUKReplacer lru_replacer(num_frames, k);
+
+  // Reference model: the full access history of every tracked frame.
+  std::vector<std::vector<size_t>> history(num_frames);
+  std::vector<bool> evictable(num_frames, false);
+  size_t timestamp = 0;
+
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<frame_id_t> frame_dist(0, num_frames - 1);
+  std::uniform_int_distribution<int> op_dist(0, 9);
+
+  for (int round = 0; round < 10000; round++) {
+    auto frame_id = frame_dist(gen);
+    auto op = op_dist(gen);
+    if (op < 6) {
+      lru_replacer.RecordAccess(frame_id);
+      history[frame_id].push_back(timestamp++);
+    } else if (op < 8) {
+      lru_replacer.SetEvictable(frame_id, true);
+      evictable[frame_id] = !history[frame_id].empty();
+    } else if (op < 9) {
+      lru_replacer.SetEvictable(frame_id, false);
+      evictable[frame_id] = false;
+    } else {
+      // The victim is the frame with +inf k-distance and earliest first access, or the largest k-distance.
+      frame_id_t expected = -1;
+      bool expected_inf = false;
+      size_t expected_ts = 0;
+      for (size_t fid = 0; fid < num_frames; fid++) {
+        if (!evictable[fid]) {
+          continue;
+        }
+        const auto &h = history[fid];
+        bool inf = h.size() < k;
+        size_t ts = inf ? h.front() : h[h.size() - k];
+        if (expected == -1 || (inf && !expected_inf) || (inf == expected_inf && ts < expected_ts)) {
+          expected = static_cast<frame_id_t>(fid);
+          expected_inf = inf;
+          expected_ts = ts;
+        }
+      }
+
+      // EvictionCandidates() lists the frames in the order Evict() would pick them.
+      std::vector<frame_id_t> expected_order;
+      for (size_t fid = 0; fid < num_frames; fid++) {
+        if (evictable[fid]) {
+          expected_order.push_back(static_cast<frame_id_t>(fid));
+        }
+      }
+      auto order_key = [&](frame_id_t fid) {
+        const auto &h = history[fid];
+        return h.size() < k ? std::make_pair(0, h.front()) : std::make_pair(1, h[h.size() - k]);
+      };
+      std::sort(expected_order.begin(), expected_order.end(),
+                [&](frame_id_t lhs, frame_id_t rhs) { return order_key(lhs) < order_key(rhs); });
+      ASSERT_EQ(expected_order, lru_replacer.EvictionCandidates(num_frames));
+
+      frame_id_t victim;
+      if (expected == -1) {
+        ASSERT_FALSE(lru_replacer.Evict(&victim));
+      } else {
+        ASSERT_TRUE(lru_replacer.Evict(&victim));
+        ASSERT_EQ(expected, victim);
+        history[victim].clear();
+        evictable[victim] = false;
+      }
+    }
+
+    size_t size = 0;
+    for (size_t fid = 0; fid < num_frames; fid++) {
+      size += evictable[fid] ? 1 : 0;
+    }
+    ASSERT_EQ(size, lru_replacer.Size());
+  }
+}
 }  // namespace bustub
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table_test.cpp
+//
+// Identification: test/buffer/page_table_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+#include <random>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(4);
+  EXPECT_EQ(-1, page_table.Find(0));
+
+  page_table.Insert(0, 3);
+  page_table.Insert(8, 2);
+  page_table.Insert(-5, 1);
+  EXPECT_EQ(3, page_table.Find(0));
+  EXPECT_EQ(2, page_table.Find(8));
+  EXPECT_EQ(1, page_table.Find(-5));
+  EXPECT_EQ(-1, page_table.Find(1));
+  EXPECT_EQ(3, page_table.Size());
+
+  page_table.Erase(0);
+  page_table.Erase(1);
+  EXPECT_EQ(-1, page_table.Find(0));
+  EXPECT_EQ(2, page_table.Find(8));
+  EXPECT_EQ(2, page_table.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, RandomTest) {
+  const size_t num_frames = 100;
+  PageTable page_table(num_frames);
+  // Reference model.
+  std::unordered_map<page_id_t, frame_id_t> reference;
+
+  std::mt19937 gen(15445);
+  // few distinct page ids, so the table is always close to full and clusters get long
+  std::uniform_int_distribution<page_id_t> page_dist(0, 2 * num_frames);
+  for (int round = 0; round < 100000; round++) {
+    page_id_t page_id = page_dist(gen);
+    if (reference.count(page_id) != 0) {
+      page_table.Erase(page_id);
+      reference.erase(page_id);
+    } else if (reference.size() < num_frames) {
+      auto frame_id = static_cast<frame_id_t>(round % num_frames);
+      page_table.Insert(page_id, frame_id);
+      reference[page_id] = frame_id;
+    }
+
+    page_id = page_dist(gen);
+    auto iter = reference.find(page_id);
+    ASSERT_EQ(iter == reference.end() ? -1 : iter->second, page_table.Find(page_id));
+    ASSERT_EQ(reference.size(), page_table.Size());
+  }
+}
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -17,13 +18,15 @@
 #include "common/logger.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_header_page.h"
 #include "storage/page/hash_table_directory_page.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -51,12 +54,13 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
   bpm->UnpinPage(directory_page_id, true);
   disk_manager->ShutDown();
   remove("test.db");
+  remove("test.log");
   delete disk_manager;
   delete bpm;
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
+TEST(HashTablePageTest, BucketPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -68,7 +72,7 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
 
   // insert a few (key, value) pairs
   for (unsigned i = 0; i < 10; i++) {
-    assert(bucket_page->Insert(i, i, IntComparator()));
+    assert(bucket_page->Insert(i, i, i, IntComparator()));
   }
 
   // check for the inserted pairs
@@ -80,7 +84,7 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   // remove a few pairs
   for (unsigned i = 0; i < 10; i++) {
     if (i % 2 == 1) {
-      assert(bucket_page->Remove(i, i, IntComparator()));
+      assert(bucket_page->Remove(i, i, i, IntComparator()));
     }
   }
 
@@ -101,7 +105,7 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   // try to remove the already-removed pairs
   for (unsigned i = 0; i < 10; i++) {
     if (i % 2 == 1) {
-      assert(!bucket_page->Remove(i, i, IntComparator()));
+      assert(!bucket_page->Remove(i, i, i, IntComparator()));
     }
   }
 
@@ -109,8 +113,79 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   bpm->UnpinPage(bucket_page_id, true);
   disk_manager->ShutDown();
   remove("test.db");
+  remove("test.log");
   delete disk_manager;
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageFingerprintTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(5, disk_manager.get());
+
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_page =
+      reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(bpm->NewPage(&bucket_page_id)->GetData());
+
+  // Keys sharing a fingerprint are told apart by the comparator; hash 0 and 1 << 12 differ only in the fingerprint.
+  auto hash_of = [](int key) -> uint32_t { return (key % 3 == 0) ? 0 : (1U << 12); };
+  int capacity = 0;
+  for (; !bucket_page->IsFull(); capacity++) {
+    ASSERT_TRUE(bucket_page->Insert(capacity, capacity, hash_of(capacity), IntComparator()));
+  }
+  // A bucket spans several groups of 16 fingerprints, the last possibly partial.
+  ASSERT_GT(capacity, 16);
+  ASSERT_FALSE(bucket_page->Insert(-1, -1, 0, IntComparator()));
+  for (int i = 0; i < capacity; i++) {
+    std::vector<int> result;
+    ASSERT_TRUE(bucket_page->GetValue(i, hash_of(i), IntComparator(), &result));
+    ASSERT_EQ(std::vector<int>{i}, result);
+    // The same key under another fingerprint is never looked at.
+    ASSERT_FALSE(bucket_page->GetValue(i, hash_of(i) ^ (1U << 12), IntComparator(), &result));
+  }
+
+  // Removing leaves tombstones the search walks past, and the next insert takes the first of them.
+  for (int i = 0; i < capacity; i += 2) {
+    ASSERT_TRUE(bucket_page->Remove(i, i, hash_of(i), IntComparator()));
+  }
+  std::vector<int> result;
+  ASSERT_FALSE(bucket_page->GetValue(0, hash_of(0), IntComparator(), &result));
+  int last_odd = (capacity - 1) % 2 == 1 ? capacity - 1 : capacity - 2;
+  ASSERT_TRUE(bucket_page->GetValue(last_odd, hash_of(last_odd), IntComparator(), &result));
+  ASSERT_TRUE(bucket_page->Insert(0, 7, 0, IntComparator()));
+  ASSERT_TRUE(bucket_page->IsReadable(0));
+  ASSERT_EQ(7, bucket_page->ValueAt(0));
+  ASSERT_EQ(capacity / 2 + 1, bucket_page->NumReadable());
+
+  bpm->UnpinPage(bucket_page_id, true);
+}
+
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, DirectoryHeaderPageTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(5, disk_manager.get());
+
+  page_id_t header_page_id = INVALID_PAGE_ID;
+  auto header_page = reinterpret_cast<HashTableDirectoryHeaderPage *>(bpm->NewPage(&header_page_id)->GetData());
+  header_page->Init(2);
+  EXPECT_EQ(4, header_page->MaxSize());
+
+  // The two most significant bits of the hash pick the directory.
+  EXPECT_EQ(0, header_page->HashToDirectoryIndex(0x3FFFFFFF));
+  EXPECT_EQ(1, header_page->HashToDirectoryIndex(0x40000000));
+  EXPECT_EQ(2, header_page->HashToDirectoryIndex(0x80000001));
+  EXPECT_EQ(3, header_page->HashToDirectoryIndex(0xFFFFFFFF));
+
+  for (uint32_t i = 0; i < header_page->MaxSize(); i++) {
+    EXPECT_EQ(INVALID_PAGE_ID, header_page->GetDirectoryPageId(i));
+  }
+  header_page->SetDirectoryPageId(2, 10);
+  EXPECT_EQ(10, header_page->GetDirectoryPageId(2));
+
+  header_page->Init(0);
+  EXPECT_EQ(0, header_page->HashToDirectoryIndex(0xFFFFFFFF));
+
+  bpm->UnpinPage(header_page_id, true);
+}
+
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -18,13 +19,14 @@
 #include "container/disk/hash/disk_extendible_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(50, disk_manager);
   DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
@@ -113,8 +115,137 @@ TEST(HashTableTest, DISABLED_SampleTest) {
 
   disk_manager->ShutDown();
   remove("test.db");
+  remove("test.log");
   delete disk_manager;
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, SplitMergeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  // A single directory.
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), HashFunction<int>(), 0);
+
+  // Far more keys than one bucket holds, so the directory has to grow several times.
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_GT(ht.GetGlobalDepth(), 4);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(res, std::vector<int>{i});
+  }
+
+  // Emptied buckets merge with their split images, until the directory is back to a single bucket.
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(ht.GetGlobalDepth(), 0);
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 0, &res));
+}
+
+namespace {
+
+template <typename Hasher>
+void CheckHashAlgorithm() {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator, HashFunction<int, Hasher>> ht(
+      "blah", bpm.get(), IntComparator(), HashFunction<int, Hasher>(), 0);
+
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(res, std::vector<int>{i});
+  }
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  EXPECT_EQ(ht.GetGlobalDepth(), 0);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, HashAlgorithmTest) {
+  CheckHashAlgorithm<WyHasher>();
+  CheckHashAlgorithm<Crc32cHasher>();
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, MultipleDirectoryTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), HashFunction<int>(), 2);
+
+  // More keys than one directory can hold, at 512 buckets of 439 int pairs (BUCKET_ARRAY_SIZE).
+  const int num_keys = 300000;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i)) << i;
+  }
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_keys; i += 7) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(res, std::vector<int>{i});
+  }
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(ht.GetGlobalDepth(), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), HashFunction<int>());
+
+  // Writers insert and then remove disjoint keys while readers look up keys that are never removed.
+  const int num_threads = 4;
+  const int keys_per_thread = 5000;
+  for (int i = 0; i < keys_per_thread; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, -i - 1, i));
+  }
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < num_threads; thread_id++) {
+    threads.emplace_back([&ht, thread_id, keys_per_thread] {
+      for (int i = thread_id * keys_per_thread; i < (thread_id + 1) * keys_per_thread; i++) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+      }
+      for (int i = thread_id * keys_per_thread; i < (thread_id + 1) * keys_per_thread; i += 2) {
+        EXPECT_TRUE(ht.Remove(nullptr, i, i));
+      }
+    });
+    threads.emplace_back([&ht, keys_per_thread] {
+      for (int i = 0; i < keys_per_thread; i++) {
+        std::vector<int> res;
+        ht.GetValue(nullptr, -i - 1, &res);
+        EXPECT_EQ(res, std::vector<int>{i});
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    std::vector<int> res;
+    ASSERT_EQ(ht.GetValue(nullptr, i, &res), i % 2 == 1) << i;
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/linear_probe_hash_table_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SampleTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), 1000, HashFunction<int>());
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i + 1));
+  }
+  // The same pair cannot be inserted twice.
+  EXPECT_FALSE(ht.Insert(nullptr, 3, 3));
+
+  for (int i = 0; i < 5; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(res, (std::vector<int>{i, 2 * i + 1}));
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+
+  EXPECT_TRUE(ht.Remove(nullptr, 2, 2));
+  EXPECT_FALSE(ht.Remove(nullptr, 2, 2));
+  EXPECT_TRUE(ht.GetValue(nullptr, 2, &res));
+  EXPECT_EQ(res, std::vector<int>{5});
+  EXPECT_EQ(ht.GetSize(), 1000);
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, IncrementalResizeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), 1000, HashFunction<int>());
+
+  // Every key stays visible while the table grows, including those still waiting in the old table.
+  const int num_keys = 20000;
+  bool seen_resizing = false;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    if (ht.IsResizing()) {
+      seen_resizing = true;
+      for (int j = i; j >= 0 && j > i - 50; j--) {
+        std::vector<int> res;
+        ASSERT_TRUE(ht.GetValue(nullptr, j, &res)) << j;
+        ASSERT_EQ(res, std::vector<int>{j});
+      }
+    }
+  }
+  EXPECT_TRUE(seen_resizing);
+  EXPECT_GE(ht.GetSize(), num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+    ASSERT_EQ(res, std::vector<int>{i});
+  }
+
+  // Removes move entries along as well, and an explicit resize finishes the previous one first.
+  for (int i = 0; i < num_keys; i += 2) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.Resize(num_keys);
+  EXPECT_TRUE(ht.IsResizing());
+  EXPECT_EQ(ht.GetSize(), 2 * num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_EQ(ht.GetValue(nullptr, i, &res), i % 2 == 1) << i;
+    ASSERT_TRUE(ht.Remove(nullptr, i, i) == (i % 2 == 1));
+  }
+  EXPECT_FALSE(ht.IsResizing());
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SmallResizeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), 4000, HashFunction<int>());
+
+  const int num_keys = 1000;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  // Asking for a table smaller than the entries still leaves room for the inserts that arrive during the migration.
+  ht.Resize(1);
+  EXPECT_TRUE(ht.IsResizing());
+  EXPECT_GT(ht.GetSize(), num_keys + 4000 / LINEAR_PROBE_MIGRATE_SLOTS);
+  for (int i = num_keys; i < 4 * num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i)) << i;
+  }
+  EXPECT_FALSE(ht.IsResizing());
+  for (int i = 0; i < 4 * num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+    ASSERT_EQ(res, std::vector<int>{i});
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, HashAlgorithmTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator, HashFunction<int, WyHasher>> wyhash_ht(
+      "blah", bpm.get(), IntComparator(), 100, HashFunction<int, WyHasher>());
+  LinearProbeHashTable<int, int, IntComparator, HashFunction<int, Crc32cHasher>> crc32c_ht(
+      "blah", bpm.get(), IntComparator(), 100, HashFunction<int, Crc32cHasher>());
+
+  for (int i = 0; i < 5000; i++) {
+    ASSERT_TRUE(wyhash_ht.Insert(nullptr, i, i));
+    ASSERT_TRUE(crc32c_ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < 5000; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(wyhash_ht.GetValue(nullptr, i, &res));
+    ASSERT_TRUE(crc32c_ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(res, std::vector<int>({i, i}));
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_function_test.cpp
+//
+// Identification: test/container/hash/hash_function_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+namespace {
+
+// Sequential keys hashed into 256 buckets by the low and by the high byte of their hash; no bucket may get more
+// than twice its share.
+template <typename Hasher>
+void CheckSpread() {
+  const int num_keys = 1 << 16;
+  HashFunction<int, Hasher> hash_fn;
+  std::vector<int> low(256);
+  std::vector<int> high(256);
+  for (int key = 0; key < num_keys; key++) {
+    uint64_t hash = hash_fn.GetHash(key);
+    low[hash & 0xFF]++;
+    high[hash >> 56]++;
+  }
+  for (int bucket = 0; bucket < 256; bucket++) {
+    EXPECT_LT(low[bucket], 2 * num_keys / 256);
+    EXPECT_LT(high[bucket], 2 * num_keys / 256);
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(HashFunctionTest, Crc32cTest) {
+  // The standard check value of CRC32C.
+  std::string check = "123456789";
+  EXPECT_EQ(0xE3069283, Crc32cHasher::Crc32c(check.data(), check.size()));
+  EXPECT_EQ(0xE3069283, Crc32cHasher::SoftwareCrc(check.data(), check.size()));
+
+  // The hardware and the table agree on every length, including the tails shorter than 8 bytes.
+  std::string bytes;
+  for (int len = 0; len < 40; len++) {
+    EXPECT_EQ(Crc32cHasher::SoftwareCrc(bytes.data(), bytes.size()), Crc32cHasher::Crc32c(bytes.data(), bytes.size()))
+        << "length " << len;
+    bytes.push_back(static_cast<char>(len * 37 + 11));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashFunctionTest, IntegerPathTest) {
+  // MurmurHash3 and CRC32C hash a 4 or 8 byte key the same way on the integer path as on the byte path.
+  for (uint64_t value : {uint64_t{0}, uint64_t{1}, uint64_t{0xDEADBEEF}, uint64_t{0x0123456789ABCDEF}}) {
+    auto value32 = static_cast<uint32_t>(value);
+    EXPECT_EQ(MurmurHash3Hasher::Hash(&value, sizeof(value)), MurmurHash3Hasher::HashInteger(value));
+    EXPECT_EQ(MurmurHash3Hasher::Hash(&value32, sizeof(value32)), MurmurHash3Hasher::HashInteger(value32));
+    EXPECT_EQ(Crc32cHasher::Hash(&value, sizeof(value)), Crc32cHasher::HashInteger(value));
+    EXPECT_EQ(Crc32cHasher::Hash(&value32, sizeof(value32)), Crc32cHasher::HashInteger(value32));
+  }
+
+  // So the default hash of an existing key does not change.
+  int key = 12345;
+  uint64_t hash[2];
+  murmur3::MurmurHash3_x64_128(&key, sizeof(key), 0, &hash);
+  EXPECT_EQ(hash[0], HashFunction<int>().GetHash(key));
+}
+
+// NOLINTNEXTLINE
+TEST(HashFunctionTest, SpreadTest) {
+  CheckSpread<MurmurHash3Hasher>();
+  CheckSpread<WyHasher>();
+  CheckSpread<Crc32cHasher>();
+
+  // Keys longer than 8 bytes take the byte path; keys differing in one byte hash apart.
+  HashFunction<GenericKey<64>, WyHasher> wyhash;
+  HashFunction<GenericKey<64>, Crc32cHasher> crc32c;
+  GenericKey<64> lhs;
+  GenericKey<64> rhs;
+  lhs.SetFromInteger(7);
+  rhs.SetFromInteger(7);
+  EXPECT_EQ(wyhash.GetHash(lhs), wyhash.GetHash(rhs));
+  EXPECT_EQ(crc32c.GetHash(lhs), crc32c.GetHash(rhs));
+  rhs.SetFromInteger(8);
+  EXPECT_NE(wyhash.GetHash(lhs), wyhash.GetHash(rhs));
+  EXPECT_NE(crc32c.GetHash(lhs), crc32c.GetHash(rhs));
+}
+
+}  // namespace bustub
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// optimizer_test.cpp
+//
+// Identification: test/optimizer/optimizer_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * Runs a statement on an in-memory instance and returns what it writes. Planning only needs the catalog, so the
+ * tests below create tables and indexes and EXPLAIN queries without running any executor.
+ */
+auto Execute(BustubInstance *bustub, const std::string &sql) -> std::string {
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  bustub->ExecuteSql(sql, writer);
+  return ss.str();
+}
+
+/** @return the plan the optimizer produces for query */
+auto Explain(BustubInstance *bustub, const std::string &query) -> std::string {
+  return Execute(bustub, "EXPLAIN (o) " + query);
+}
+
+auto Contains(const std::string &plan, const std::string &part) -> bool {
+  return plan.find(part) != std::string::npos;
+}
+
+/** An instance with `t (k INT, v INT, w INT)` and an index `t_k` on k, which gets index_oid=0. */
+auto MakeInstance() -> std::unique_ptr<BustubInstance> {
+  auto bustub = std::make_unique<BustubInstance>();
+  Execute(bustub.get(), "CREATE TABLE t (k INT, v INT, w INT);");
+  Execute(bustub.get(), "CREATE INDEX t_k ON t (k);");
+  return bustub;
+}
+
+}  // namespace
+
+TEST(OptimizerTest, OrderByDescAsReverseIndexScan) {
+  auto bustub = MakeInstance();
+
+  auto plan = Explain(bustub.get(), "SELECT * FROM t ORDER BY k DESC;");
+  EXPECT_TRUE(Contains(plan, "IndexScan { index_oid=0, reverse }")) << plan;
+  EXPECT_FALSE(Contains(plan, "Sort")) << plan;
+  EXPECT_FALSE(Contains(plan, "TopN")) << plan;
+
+  plan = Explain(bustub.get(), "SELECT * FROM t ORDER BY k DESC LIMIT 3;");
+  EXPECT_TRUE(Contains(plan, "Limit")) << plan;
+  EXPECT_TRUE(Contains(plan, "IndexScan { index_oid=0, reverse }")) << plan;
+  EXPECT_FALSE(Contains(plan, "Sort")) << plan;
+  EXPECT_FALSE(Contains(plan, "TopN")) << plan;
+
+  // Ascending orders scan forward; orders the index cannot produce keep their sort.
+  plan = Explain(bustub.get(), "SELECT * FROM t ORDER BY k;");
+  EXPECT_TRUE(Contains(plan, "IndexScan { index_oid=0 }")) << plan;
+  plan = Explain(bustub.get(), "SELECT * FROM t ORDER BY v DESC;");
+  EXPECT_TRUE(Contains(plan, "Sort")) << plan;
+  EXPECT_FALSE(Contains(plan, "IndexScan")) << plan;
+}
+
+TEST(OptimizerTest, SeqScanAsIndexScanBounds) {
+  auto bustub = MakeInstance();
+
+  auto plan = Explain(bustub.get(), "SELECT * FROM t WHERE k > 3 AND k <= 9;");
+  EXPECT_TRUE(Contains(plan, "IndexScan { index_oid=0, range=(3, 9], filter=")) << plan;
+
+  plan = Explain(bustub.get(), "SELECT * FROM t WHERE 3 < k;");
+  EXPECT_TRUE(Contains(plan, "IndexScan { index_oid=0, range=(3, +inf), filter=")) << plan;
+
+  plan = Explain(bustub.get(), "SELECT * FROM t WHERE k >= 3 AND k < 9 AND k > 5;");
+  EXPECT_TRUE(Contains(plan, "IndexScan { index_oid=0, range=(5, 9), filter=")) << plan;
+
+  plan = Explain(bustub.get(), "SELECT * FROM t WHERE k = 5;");
+  EXPECT_TRUE(Contains(plan, "IndexScan { index_oid=0, range=[5, 5], filter=")) << plan;
+
+  // Comparisons on other columns are left to the filter.
+  plan = Explain(bustub.get(), "SELECT * FROM t WHERE v = 5 AND k <= 7;");
+  EXPECT_TRUE(Contains(plan, "IndexScan { index_oid=0, range=(-inf, 7], filter=")) << plan;
+
+  // Neither a NotEqual nor a constant of another type than the key yields a bound.
+  plan = Explain(bustub.get(), "SELECT * FROM t WHERE k <> 5;");
+  EXPECT_TRUE(Contains(plan, "SeqScan")) << plan;
+  EXPECT_FALSE(Contains(plan, "IndexScan")) << plan;
+  plan = Explain(bustub.get(), "SELECT * FROM t WHERE k = '5';");
+  EXPECT_TRUE(Contains(plan, "SeqScan")) << plan;
+  EXPECT_FALSE(Contains(plan, "IndexScan")) << plan;
+  plan = Explain(bustub.get(), "SELECT * FROM t WHERE k > '5' AND k < 9;");
+  EXPECT_TRUE(Contains(plan, "IndexScan { index_oid=0, range=(-inf, 9), filter=")) << plan;
+  plan = Explain(bustub.get(), "SELECT * FROM t WHERE v = 5;");
+  EXPECT_TRUE(Contains(plan, "SeqScan")) << plan;
+  EXPECT_FALSE(Contains(plan, "IndexScan")) << plan;
+}
+
+TEST(OptimizerTest, IndexOnlyScan) {
+  auto bustub = std::make_unique<BustubInstance>();
+  Execute(bustub.get(), "CREATE TABLE u (k INT, v INT, w INT);");
+  Execute(bustub.get(), "CREATE INDEX u_k ON u (k) WITH (include = v);");
+
+  // Queries that read only the key and the included column never need the table.
+  auto plan = Explain(bustub.get(), "SELECT k, v FROM u WHERE k > 3;");
+  EXPECT_TRUE(Contains(plan, "IndexScan { index_oid=0, range=(3, +inf), index_only, filter=")) << plan;
+  plan = Explain(bustub.get(), "SELECT v FROM u WHERE k = 3 AND v > 1;");
+  EXPECT_TRUE(Contains(plan, "index_only")) << plan;
+  plan = Explain(bustub.get(), "SELECT SUM(v) FROM u WHERE k < 10;");
+  EXPECT_TRUE(Contains(plan, "index_only")) << plan;
+
+  // Any use of a column outside the index, in the output, the filter or above, keeps the table lookups.
+  plan = Explain(bustub.get(), "SELECT * FROM u WHERE k > 3;");
+  EXPECT_TRUE(Contains(plan, "IndexScan")) << plan;
+  EXPECT_FALSE(Contains(plan, "index_only")) << plan;
+  plan = Explain(bustub.get(), "SELECT k, w FROM u WHERE k > 3;");
+  EXPECT_TRUE(Contains(plan, "IndexScan")) << plan;
+  EXPECT_FALSE(Contains(plan, "index_only")) << plan;
+  plan = Explain(bustub.get(), "SELECT k FROM u WHERE k > 3 AND w = 1;");
+  EXPECT_TRUE(Contains(plan, "IndexScan")) << plan;
+  EXPECT_FALSE(Contains(plan, "index_only")) << plan;
+  plan = Explain(bustub.get(), "SELECT SUM(w) FROM u WHERE k < 10;");
+  EXPECT_TRUE(Contains(plan, "IndexScan")) << plan;
+  EXPECT_FALSE(Contains(plan, "index_only")) << plan;
+}
+
+}  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager_test.cpp
+//
+// Identification: test/storage/async_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_disk_manager.h"
+
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <vector>
+
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+class AsyncDiskManagerTest : public ::testing::Test {
+ protected:
+  // This function is called before every test.
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  // This function is called after every test.
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(AsyncDiskManagerTest, ReadWritePageTest) {
+  const size_t num_pages = 64;
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto async_disk_manager = std::make_unique<AsyncDiskManager>(disk_manager.get());
+
+  // Scenario: many writes in flight at once all land.
+  std::vector<char> data(num_pages * BUSTUB_PAGE_SIZE);
+  std::vector<std::future<bool>> futures;
+  for (size_t i = 0; i < num_pages; i++) {
+    snprintf(&data[i * BUSTUB_PAGE_SIZE], BUSTUB_PAGE_SIZE, "page %zu", i);
+    futures.push_back(async_disk_manager->SubmitWrite(static_cast<page_id_t>(i), &data[i * BUSTUB_PAGE_SIZE]));
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+
+  // Scenario: reads complete with the data that was written.
+  std::vector<char> buf(num_pages * BUSTUB_PAGE_SIZE);
+  futures.clear();
+  for (size_t i = 0; i < num_pages; i++) {
+    futures.push_back(async_disk_manager->SubmitRead(static_cast<page_id_t>(i), &buf[i * BUSTUB_PAGE_SIZE]));
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  EXPECT_EQ(0, memcmp(data.data(), buf.data(), data.size()));
+
+  // Scenario: a request the disk manager fails completes with its exception, and reports failure to on_complete.
+  disk_manager->ShutDown();
+  std::promise<bool> promise;
+  auto future = promise.get_future();
+  std::promise<bool> success;
+  async_disk_manager->Submit(
+      {false, buf.data(), 0, std::move(promise), [&success](bool succeeded) { success.set_value(succeeded); }});
+  EXPECT_THROW(future.get(), Exception);
+  EXPECT_FALSE(success.get_future().get());
+  async_disk_manager.reset();
+}
+
+// NOLINTNEXTLINE
+TEST_F(AsyncDiskManagerTest, RequestsOverlapTest) {
+  const size_t num_threads = 4;
+  const size_t num_requests = 8;
+  const size_t latency_ms = 50;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto async_disk_manager = std::make_unique<AsyncDiskManager>(disk_manager.get(), num_threads);
+  disk_manager->SetLatency(latency_ms);
+
+  // Scenario: requests are served by several threads at once, instead of one after the other.
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::future<bool>> futures;
+  for (size_t i = 0; i < num_requests; i++) {
+    futures.push_back(async_disk_manager->SubmitWrite(static_cast<page_id_t>(i), data));
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  EXPECT_LT(elapsed.count(), num_requests * latency_ms * 3 / 4);
+}
+
+}  // namespace bustub
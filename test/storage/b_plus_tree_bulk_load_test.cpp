@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+using BulkLoadTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+namespace {
+
+auto MakeItems(int64_t first, int64_t last, int64_t step) -> std::vector<std::pair<GenericKey<8>, RID>> {
+  std::vector<std::pair<GenericKey<8>, RID>> items;
+  for (int64_t key = first; key <= last; key += step) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    items.emplace_back(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF));
+  }
+  return items;
+}
+
+// Checks every non-root node against its size bounds and returns the depth of the leaves below page_id.
+auto CheckNodeSizes(BufferPoolManager *bpm, page_id_t page_id, bool is_root) -> int {
+  auto guard = bpm->FetchPageRead(page_id);
+  auto *page = guard.As<BPlusTreePage>();
+  EXPECT_LE(page->GetSize(), page->GetMaxSize());
+  if (!is_root) {
+    EXPECT_GE(page->GetSize(), page->GetMinSize());
+  }
+  if (page->IsLeafPage()) {
+    return 1;
+  }
+  auto *internal = guard.As<BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>>();
+  int depth = CheckNodeSizes(bpm, internal->ValueAt(0), false);
+  for (int i = 1; i < internal->GetSize(); i++) {
+    EXPECT_EQ(CheckNodeSizes(bpm, internal->ValueAt(i), false), depth);
+  }
+  return depth + 1;
+}
+
+}  // namespace
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // Every fill factor and tree size has to come out with no underfull nodes, from a single leaf up to several levels.
+  for (double fill_factor : {0.1, 0.5, 0.7, 1.0}) {
+    for (int64_t total_keys : {1, 4, 5, 13, 100, 2000}) {
+      page_id_t tree_header_id;
+      bpm->NewPage(&tree_header_id);
+      BulkLoadTree tree("foo_pk", tree_header_id, bpm, comparator, 4, 5);
+      ASSERT_TRUE(tree.BulkLoad(MakeItems(2, 2 * total_keys, 2), fill_factor));
+      CheckNodeSizes(bpm, tree.GetRootPageId(), true);
+
+      int64_t current_key = 2;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+        ASSERT_EQ((*iter).first.ToString(), current_key);
+        current_key += 2;
+      }
+      ASSERT_EQ(current_key, 2 * total_keys + 2);
+
+      // The loaded tree is an ordinary tree: point lookups, inserts and removes work on it.
+      std::vector<RID> result;
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(2 * total_keys);
+      ASSERT_TRUE(tree.GetValue(index_key, &result));
+      for (int64_t key = 1; key <= 2 * total_keys + 1; key += 2) {
+        index_key.SetFromInteger(key);
+        ASSERT_TRUE(tree.Insert(index_key, RID(0, key)));
+      }
+      for (int64_t key = 2; key <= 2 * total_keys; key++) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, nullptr);
+      }
+      CheckNodeSizes(bpm, tree.GetRootPageId(), true);
+      ASSERT_EQ((*tree.Begin()).first.ToString(), 1);
+
+      bpm->UnpinPage(tree_header_id, true);
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, BulkLoadRejectTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BulkLoadTree tree("foo_pk", page_id, bpm, comparator, 4, 5);
+
+  // Unsorted or duplicate keys are refused without building anything.
+  auto items = MakeItems(1, 10, 1);
+  std::swap(items[3], items[4]);
+  ASSERT_FALSE(tree.BulkLoad(items));
+  items = MakeItems(1, 10, 1);
+  items[4] = items[3];
+  ASSERT_FALSE(tree.BulkLoad(items));
+  ASSERT_TRUE(tree.IsEmpty());
+
+  // So is loading into a tree that already has keys.
+  ASSERT_TRUE(tree.BulkLoad(MakeItems(1, 10, 1)));
+  ASSERT_FALSE(tree.BulkLoad(MakeItems(20, 30, 1)));
+  ASSERT_EQ((*tree.Begin()).first.ToString(), 1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_index_test.cpp
+//
+// Identification: test/storage/b_plus_tree_index_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeKeyTuple(int32_t a, int32_t b, const Schema *key_schema) -> Tuple {
+  return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetIntegerValue(b)}, key_schema);
+}
+
+auto ScanKey(BPlusTreeIndexForTwoIntegerColumn *index, int32_t a, int32_t b) -> std::vector<RID> {
+  std::vector<RID> result;
+  index->ScanKey(MakeKeyTuple(a, b, index->GetKeySchema()), &result, nullptr);
+  return result;
+}
+
+}  // namespace
+
+TEST(BPlusTreeIndexTest, NonUniqueIndexTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto table_schema = ParseCreateStatement("x integer,a integer,b integer");
+  auto metadata = std::make_unique<IndexMetadata>("foo_ab", "foo", table_schema.get(), std::vector<uint32_t>{1, 2},
+                                                  false);
+  BPlusTreeIndexForTwoIntegerColumn index(std::move(metadata), bpm.get());
+
+  // Ten keys with 30 rows each, inserted interleaved.
+  for (int32_t slot = 0; slot < 30; slot++) {
+    for (int32_t a = -5; a < 5; a++) {
+      ASSERT_TRUE(index.InsertEntry(MakeKeyTuple(a, 7, index.GetKeySchema()), RID(a, slot), nullptr));
+    }
+  }
+  // The same row cannot be indexed twice.
+  ASSERT_FALSE(index.InsertEntry(MakeKeyTuple(0, 7, index.GetKeySchema()), RID(0, 3), nullptr));
+
+  for (int32_t a = -5; a < 5; a++) {
+    std::vector<RID> expected;
+    for (int32_t slot = 0; slot < 30; slot++) {
+      expected.emplace_back(a, slot);
+    }
+    ASSERT_EQ(ScanKey(&index, a, 7), expected);
+  }
+  ASSERT_TRUE(ScanKey(&index, 0, 6).empty());
+  ASSERT_TRUE(ScanKey(&index, 0, 8).empty());
+
+  // Deleting removes only the given row.
+  index.DeleteEntry(MakeKeyTuple(0, 7, index.GetKeySchema()), RID(0, 3), nullptr);
+  auto rids = ScanKey(&index, 0, 7);
+  ASSERT_EQ(rids.size(), 29);
+  ASSERT_EQ(std::find(rids.begin(), rids.end(), RID(0, 3)), rids.end());
+
+  // Iteration yields the entries in key order, the rows of a key in RID order.
+  int count = 0;
+  RID last_rid(-5, 0);
+  for (auto iter = index.GetBeginIterator(); !iter.IsEnd(); ++iter) {
+    auto [key, rid] = *iter;
+    ASSERT_EQ(key.GetRid(), rid);
+    ASSERT_EQ(key.ToValue(index.GetKeySchema(), 0).GetAs<int32_t>(), rid.GetPageId());
+    ASSERT_TRUE(count == 0 || rid.Get() > last_rid.Get());
+    last_rid = rid;
+    count++;
+  }
+  ASSERT_EQ(count, 299);
+}
+
+TEST(BPlusTreeIndexTest, IncludedColumnTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto table_schema = ParseCreateStatement("a integer,b integer,c integer");
+  // Searched by c, with b included.
+  auto metadata = std::make_unique<IndexMetadata>("foo_c", "foo", table_schema.get(), std::vector<uint32_t>{2, 1},
+                                                  false, 1);
+  BPlusTreeIndexForTwoIntegerColumn index(std::move(metadata), bpm.get());
+
+  for (int32_t slot = 0; slot < 100; slot++) {
+    ASSERT_TRUE(index.InsertEntry(MakeKeyTuple(slot % 10, -slot, index.GetKeySchema()), RID(1, slot), nullptr));
+  }
+
+  // A key lookup ignores the included column of the key it is given.
+  std::vector<RID> expected;
+  for (int32_t slot = 3; slot < 100; slot += 10) {
+    expected.emplace_back(1, slot);
+  }
+  auto rids = ScanKey(&index, 3, 12345);
+  std::sort(rids.begin(), rids.end(), [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+  ASSERT_EQ(rids, expected);
+
+  // A range scan on the search column hands out the included column with every entry.
+  KeyRangeScan<IntegerKeyType> scan;
+  scan.lower_ = index.MakeBoundKey({ValueFactory::GetIntegerValue(3)}, false);
+  scan.upper_ = index.MakeBoundKey({ValueFactory::GetIntegerValue(4)}, true);
+  std::vector<std::pair<IntegerKeyType, RID>> entries;
+  while (index.ScanRange(&scan, &entries)) {
+  }
+  ASSERT_EQ(entries.size(), 20);
+  for (const auto &[key, rid] : entries) {
+    ASSERT_EQ(key.ToValue(index.GetKeySchema(), 0).GetAs<int32_t>(), rid.GetSlotNum() % 10);
+    ASSERT_EQ(key.ToValue(index.GetKeySchema(), 1).GetAs<int32_t>(), -static_cast<int32_t>(rid.GetSlotNum()));
+  }
+
+  // Deletes are given the included column along with the key, as they are built from the deleted tuple.
+  index.DeleteEntry(MakeKeyTuple(3, -13, index.GetKeySchema()), RID(1, 13), nullptr);
+  ASSERT_EQ(ScanKey(&index, 3, 0).size(), 9);
+}
+
+TEST(BPlusTreeIndexTest, UniqueIndexTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto table_schema = ParseCreateStatement("a integer,b integer");
+  auto metadata = std::make_unique<IndexMetadata>("foo_ab", "foo", table_schema.get(), std::vector<uint32_t>{0, 1});
+  BPlusTreeIndexForTwoIntegerColumn index(std::move(metadata), bpm.get());
+
+  ASSERT_TRUE(index.InsertEntry(MakeKeyTuple(1, 2, index.GetKeySchema()), RID(0, 1), nullptr));
+  ASSERT_FALSE(index.InsertEntry(MakeKeyTuple(1, 2, index.GetKeySchema()), RID(0, 2), nullptr));
+  ASSERT_EQ(ScanKey(&index, 1, 2), std::vector<RID>{RID(0, 1)});
+  index.DeleteEntry(MakeKeyTuple(1, 2, index.GetKeySchema()), RID(), nullptr);
+  ASSERT_TRUE(ScanKey(&index, 1, 2).empty());
+}
+
+}  // namespace bustub
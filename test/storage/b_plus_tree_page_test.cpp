@@ -0,0 +1,403 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_page_test.cpp
+//
+// Identification: test/storage/b_plus_tree_page_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+using VarKey = GenericKey<64>;
+using VarComparator = GenericComparator<64>;
+using VarLeafPage = BPlusTreeLeafPage<VarKey, RID, VarComparator>;
+using VarInternalPage = BPlusTreeInternalPage<VarKey, page_id_t, VarComparator>;
+using VarTree = BPlusTree<VarKey, RID, VarComparator>;
+
+namespace {
+
+/** How many entries of 64 byte keys a leaf held as a plain array of pairs. */
+const int FIXED_LEAF_SIZE = (BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<VarKey, RID>);
+
+auto MakeVarKey(const std::string &str, const Schema &key_schema) -> VarKey {
+  VarKey key;
+  key.SetFromKey(Tuple({ValueFactory::GetVarcharValue(str)}, &key_schema), key_schema);
+  return key;
+}
+
+/** Strings sharing a long prefix, like the ids of one table; ordered as their numbers. */
+auto MakeStrings(int count) -> std::vector<std::string> {
+  std::vector<std::string> strings;
+  for (int i = 0; i < count; i++) {
+    strings.push_back(fmt::format("customer-account-{:08}", i));
+  }
+  return strings;
+}
+
+// Checks that every key below page_id is in [low, high) and sorted, and returns the depth of the leaves below it.
+auto CheckTree(BufferPoolManager *bpm, const VarComparator &comparator, page_id_t page_id,
+               const std::optional<VarKey> &low, const std::optional<VarKey> &high, int *num_leaves) -> int {
+  auto guard = bpm->FetchPageRead(page_id);
+  auto *page = guard.As<BPlusTreePage>();
+  if (page->IsLeafPage()) {
+    auto *leaf = guard.As<VarLeafPage>();
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      EXPECT_TRUE(!low.has_value() || comparator(*low, leaf->KeyAt(i)) <= 0);
+      EXPECT_TRUE(!high.has_value() || comparator(leaf->KeyAt(i), *high) < 0);
+      EXPECT_TRUE(i == 0 || comparator(leaf->KeyAt(i - 1), leaf->KeyAt(i)) < 0);
+    }
+    (*num_leaves)++;
+    return 1;
+  }
+  auto *internal = guard.As<VarInternalPage>();
+  int depth = 0;
+  for (int i = 0; i < internal->GetSize(); i++) {
+    std::optional<VarKey> child_low = i == 0 ? low : std::optional<VarKey>(internal->KeyAt(i));
+    std::optional<VarKey> child_high =
+        i + 1 == internal->GetSize() ? high : std::optional<VarKey>(internal->KeyAt(i + 1));
+    int child_depth = CheckTree(bpm, comparator, internal->ValueAt(i), child_low, child_high, num_leaves);
+    EXPECT_TRUE(i == 0 || child_depth == depth);
+    depth = child_depth;
+  }
+  return depth + 1;
+}
+
+// Checks that no page but the root is underfull.
+void CheckNoUnderfull(BufferPoolManager *bpm, page_id_t page_id, bool is_root) {
+  auto guard = bpm->FetchPageRead(page_id);
+  if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+    EXPECT_TRUE(is_root || !guard.As<VarLeafPage>()->IsUnderfull());
+    return;
+  }
+  auto *internal = guard.As<VarInternalPage>();
+  EXPECT_TRUE(is_root || !internal->IsUnderfull());
+  for (int i = 0; i < internal->GetSize(); i++) {
+    CheckNoUnderfull(bpm, internal->ValueAt(i), false);
+  }
+}
+
+/** count distinct random keys in increasing order, sharing their first prefix_size bytes. */
+template <size_t KeySize>
+auto SortedRandomKeys(size_t count, size_t prefix_size, std::mt19937_64 *rng) -> std::vector<GenericKey<KeySize>> {
+  GenericComparator<KeySize> comparator(nullptr);
+  GenericKey<KeySize> prefix;
+  for (auto &byte : prefix.data_) {
+    byte = static_cast<char>((*rng)());
+  }
+  std::vector<GenericKey<KeySize>> keys;
+  while (keys.size() < count) {
+    for (size_t i = keys.size(); i < count; i++) {
+      GenericKey<KeySize> key = prefix;
+      for (size_t j = prefix_size; j < KeySize; j++) {
+        key.data_[j] = static_cast<char>((*rng)());
+      }
+      keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end(), [&](const auto &lhs, const auto &rhs) { return comparator(lhs, rhs) < 0; });
+    keys.erase(std::unique(keys.begin(), keys.end(),
+                           [&](const auto &lhs, const auto &rhs) { return comparator(lhs, rhs) == 0; }),
+               keys.end());
+  }
+  return keys;
+}
+
+// Checks the branch-free KeyIndex() and Lookup() of word keys against a linear search with the comparator, on pages of
+// 0, 1, 2 and the max number of entries. The entries take every other one of the sorted probe keys, so the probes fall
+// below, between, onto and above them. Keys either differ from their first byte on or only in their last two.
+template <size_t KeySize>
+void CheckBranchFreeSearch() {
+  using KeyType = GenericKey<KeySize>;
+  using KeyComparator = GenericComparator<KeySize>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, RID, KeyComparator>;
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
+  static_assert(KeyAsWord<KeyType, KeyComparator>::ENABLED, "not a word key");
+  KeyComparator comparator(nullptr);
+  std::mt19937_64 rng(KeySize);
+  auto page = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+
+  for (size_t prefix_size : {size_t{0}, KeySize - 2}) {
+    for (int size : {0, 1, 2, LeafPage::MAX_SIZE}) {
+      auto keys = SortedRandomKeys<KeySize>(2 * size + 1, prefix_size, &rng);
+      auto *leaf = reinterpret_cast<LeafPage *>(page.get());
+      leaf->Init();
+      for (int i = 0; i < size; i++) {
+        leaf->InsertAt(i, keys[2 * i + 1], RID(i, i));
+      }
+      for (size_t probe = 0; probe < keys.size(); probe++) {
+        int expected = 0;
+        while (expected < size && comparator(leaf->KeyAt(expected), keys[probe]) < 0) {
+          expected++;
+        }
+        ASSERT_EQ(leaf->KeyIndex(keys[probe], comparator), expected) << "size " << size << ", probe " << probe;
+      }
+    }
+
+    // The first key of an internal page is not a key; filled with the lowest or the highest bytes, it must not
+    // change where any probe goes.
+    for (char slot_zero_byte : {'\x00', '\xFF'}) {
+      KeyType slot_zero_key;
+      memset(slot_zero_key.data_, slot_zero_byte, KeySize);
+      for (int size : {0, 1, 2, InternalPage::MAX_SIZE}) {
+        auto keys = SortedRandomKeys<KeySize>(2 * size + 1, prefix_size, &rng);
+        auto *internal = reinterpret_cast<InternalPage *>(page.get());
+        internal->Init();
+        for (int i = 0; i < size; i++) {
+          internal->InsertAt(i, i == 0 ? slot_zero_key : keys[2 * i + 1], i);
+        }
+        for (size_t probe = 0; probe < keys.size(); probe++) {
+          int expected = 0;
+          while (expected + 1 < size && comparator(internal->KeyAt(expected + 1), keys[probe]) <= 0) {
+            expected++;
+          }
+          ASSERT_EQ(internal->Lookup(keys[probe], comparator), expected) << "size " << size << ", probe " << probe;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreePageTest, SlottedLeafTest) {
+  // Scenario: 64 byte VARCHAR keys with a long common prefix go into a leaf in random order. The leaf only stores
+  // what follows the prefix, so it holds several times the entries of a plain array, and returns whole keys.
+  auto key_schema = ParseCreateStatement("a varchar(60)");
+  VarComparator comparator(key_schema.get());
+  auto page = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  auto *leaf = reinterpret_cast<VarLeafPage *>(page.get());
+  leaf->Init();
+
+  auto strings = MakeStrings(1000);
+  std::vector<int> order(strings.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(42));
+  std::vector<int> inserted;
+  for (int i : order) {
+    VarKey key = MakeVarKey(strings[i], *key_schema);
+    if (!leaf->HasRoomFor(key)) {
+      break;
+    }
+    leaf->InsertAt(leaf->KeyIndex(key, comparator), key, RID(i, i));
+    inserted.push_back(i);
+  }
+  ASSERT_GT(leaf->GetSize(), 3 * FIXED_LEAF_SIZE);
+  ASSERT_LE(leaf->GetSize(), leaf->GetMaxSize());
+
+  std::sort(inserted.begin(), inserted.end());
+  auto check = [&]() {
+    ASSERT_EQ(leaf->GetSize(), inserted.size());
+    for (size_t i = 0; i < inserted.size(); i++) {
+      VarKey key = MakeVarKey(strings[inserted[i]], *key_schema);
+      ASSERT_EQ(comparator(leaf->KeyAt(i), key), 0);
+      ASSERT_EQ(leaf->ValueAt(i), RID(inserted[i], inserted[i]));
+      ASSERT_EQ(leaf->KeyIndex(key, comparator), static_cast<int>(i));
+      auto item = leaf->ItemAt(i);
+      ASSERT_EQ(comparator(item.first, key), 0);
+    }
+  };
+  check();
+
+  // Removing entries gives back the room of their suffixes.
+  for (int i = static_cast<int>(inserted.size()) - 1; i >= 0; i--) {
+    if (i % 4 != 0) {
+      leaf->RemoveAt(i);
+      inserted.erase(inserted.begin() + i);
+    }
+  }
+  check();
+
+  // A key without the prefix shrinks it, which the remaining entries still have room for.
+  VarKey other = MakeVarKey("zebra", *key_schema);
+  strings.emplace_back("zebra");
+  inserted.push_back(static_cast<int>(strings.size()) - 1);
+  ASSERT_TRUE(leaf->HasRoomFor(other));
+  leaf->InsertAt(leaf->GetSize(), other, RID(inserted.back(), inserted.back()));
+  check();
+
+  // Splitting moves the entries, each page keeping a prefix of its own.
+  auto right_page = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  auto *right = reinterpret_cast<VarLeafPage *>(right_page.get());
+  right->Init();
+  int half = leaf->GetSize() / 2;
+  leaf->MoveSuffixTo(half, right);
+  ASSERT_EQ(leaf->GetSize(), half);
+  ASSERT_EQ(comparator(right->KeyAt(right->GetSize() - 1), other), 0);
+  ASSERT_EQ(comparator(right->KeyAt(0), MakeVarKey(strings[inserted[half]], *key_schema)), 0);
+  ASSERT_TRUE(leaf->CanAbsorb(right));
+  right->MoveSuffixTo(0, leaf);
+  check();
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreePageTest, ShortestSeparatorTest) {
+  // Scenario: the separator of two leaves is cut right after the first byte in which they differ, padded with zeros.
+  auto key_schema = ParseCreateStatement("a varchar(60)");
+  VarComparator comparator(key_schema.get());
+  VarKey left = MakeVarKey("customer-account-00001999", *key_schema);
+  VarKey right = MakeVarKey("customer-account-00002000", *key_schema);
+  VarKey separator = VarInternalPage::ShortestSeparator(left, right);
+  EXPECT_LT(comparator(left, separator), 0);
+  EXPECT_LE(comparator(separator, right), 0);
+  // The not-NULL byte, then "customer-account-0000" and the '2'.
+  size_t length = 1 + std::string("customer-account-00002").size();
+  EXPECT_EQ(memcmp(separator.data_, right.data_, length), 0);
+  for (size_t i = length; i < sizeof(separator.data_); i++) {
+    EXPECT_EQ(separator.data_[i], 0);
+  }
+
+  // A string and its extension differ where the string's terminator is; the separator ends with the byte after it.
+  VarKey prefix = MakeVarKey("customer", *key_schema);
+  VarKey extension = MakeVarKey("customer-account", *key_schema);
+  separator = VarInternalPage::ShortestSeparator(prefix, extension);
+  EXPECT_LT(comparator(prefix, separator), 0);
+  EXPECT_LT(comparator(separator, extension), 0);
+  EXPECT_EQ(separator.data_[1 + std::string("customer-").size()], 0);
+
+  // Word keys are not truncated.
+  auto int_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> int_comparator(int_schema.get());
+  GenericKey<8> low;
+  GenericKey<8> high;
+  low.SetFromInteger(255);
+  high.SetFromInteger(256);
+  EXPECT_EQ(int_comparator(BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>::ShortestSeparator(
+                               low, high),
+                           high),
+            0);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreePageTest, VariableLengthTreeTest) {
+  // Scenario: a tree of 64 byte VARCHAR keys, inserted in random order, stays a level lower than with plain arrays,
+  // where 8000 keys need more leaves than a root of 64 byte separators can point to.
+  auto key_schema = ParseCreateStatement("a varchar(60)");
+  VarComparator comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(256, disk_manager.get());
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  VarTree tree("foo_pk", page_id, bpm, comparator);
+
+  const int num_keys = 8000;
+  const int fixed_internal_size = (BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<VarKey, page_id_t>);
+  ASSERT_GT(num_keys, FIXED_LEAF_SIZE * fixed_internal_size);
+  auto strings = MakeStrings(num_keys);
+  std::vector<int> order(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(7));
+  for (int i : order) {
+    ASSERT_TRUE(tree.Insert(MakeVarKey(strings[i], *key_schema), RID(i, i)));
+  }
+
+  int num_leaves = 0;
+  EXPECT_EQ(CheckTree(bpm, comparator, tree.GetRootPageId(), std::nullopt, std::nullopt, &num_leaves), 2);
+  EXPECT_LT(num_leaves, num_keys / FIXED_LEAF_SIZE);
+  int index = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter, ++index) {
+    ASSERT_EQ(comparator((*iter).first, MakeVarKey(strings[index], *key_schema)), 0);
+    ASSERT_EQ((*iter).second, RID(index, index));
+  }
+  ASSERT_EQ(index, num_keys);
+
+  // Remove all but every fifth key, merging and redistributing pages of different byte sizes.
+  for (int i : order) {
+    if (i % 5 != 0) {
+      tree.Remove(MakeVarKey(strings[i], *key_schema), nullptr);
+    }
+  }
+  num_leaves = 0;
+  CheckTree(bpm, comparator, tree.GetRootPageId(), std::nullopt, std::nullopt, &num_leaves);
+  std::vector<RID> result;
+  for (int i = 0; i < num_keys; i++) {
+    result.clear();
+    ASSERT_EQ(tree.GetValue(MakeVarKey(strings[i], *key_schema), &result), i % 5 == 0);
+  }
+  index = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter, index += 5) {
+    ASSERT_EQ((*iter).second, RID(index, index));
+  }
+  ASSERT_EQ(index, num_keys);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreePageTest, VariableLengthBulkLoadTest) {
+  // Scenario: bulk loading VARCHAR keys sizes the pages by their bytes and leaves none underfull.
+  auto key_schema = ParseCreateStatement("a varchar(60)");
+  VarComparator comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(256, disk_manager.get());
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  for (double fill_factor : {0.1, 0.7, 1.0}) {
+    for (int num_keys : {1, 300, 20000}) {
+      page_id_t tree_header_id;
+      bpm->NewPage(&tree_header_id);
+      VarTree tree("foo_pk", tree_header_id, bpm, comparator);
+      auto strings = MakeStrings(num_keys);
+      std::vector<std::pair<VarKey, RID>> items;
+      for (int i = 0; i < num_keys; i++) {
+        items.emplace_back(MakeVarKey(strings[i], *key_schema), RID(i, i));
+      }
+      ASSERT_TRUE(tree.BulkLoad(items, fill_factor));
+
+      int num_leaves = 0;
+      CheckTree(bpm, comparator, tree.GetRootPageId(), std::nullopt, std::nullopt, &num_leaves);
+      CheckNoUnderfull(bpm, tree.GetRootPageId(), true);
+      int index = 0;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter, ++index) {
+        ASSERT_EQ((*iter).second, RID(index, index));
+      }
+      ASSERT_EQ(index, num_keys);
+
+      bpm->UnpinPage(tree_header_id, true);
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreePageTest, BranchFreeSearchTest) {
+  // Scenario: 4, 8 and 16 byte keys are searched as 32, 64 and 128 bit integers without calling the comparator, and
+  // find the same entries as the comparator does.
+  CheckBranchFreeSearch<4>();
+  CheckBranchFreeSearch<8>();
+  CheckBranchFreeSearch<16>();
+}
+
+}  // namespace bustub
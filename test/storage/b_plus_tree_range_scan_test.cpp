@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_range_scan_test.cpp
+//
+// Identification: test/storage/b_plus_tree_range_scan_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+namespace {
+
+auto MakeKey(int64_t key) -> GenericKey<8> {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+// Runs a range scan to the end and returns the keys it found, checking that no batch is larger than a leaf.
+auto ScanAll(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, std::optional<int64_t> lower,
+             bool lower_inclusive, std::optional<int64_t> upper, bool upper_inclusive, bool reverse = false)
+    -> std::vector<int64_t> {
+  KeyRangeScan<GenericKey<8>> scan;
+  scan.reverse_ = reverse;
+  if (lower.has_value()) {
+    scan.lower_ = MakeKey(*lower);
+  }
+  scan.lower_inclusive_ = lower_inclusive;
+  if (upper.has_value()) {
+    scan.upper_ = MakeKey(*upper);
+  }
+  scan.upper_inclusive_ = upper_inclusive;
+
+  std::vector<int64_t> keys;
+  std::vector<RID> batch;
+  while (tree->ScanRange(&scan, &batch)) {
+    EXPECT_FALSE(batch.empty());
+    EXPECT_LE(batch.size(), 4);
+    for (const auto &rid : batch) {
+      keys.push_back(rid.GetSlotNum());
+    }
+    batch.clear();
+  }
+  EXPECT_TRUE(batch.empty());
+  EXPECT_TRUE(scan.done_);
+  return keys;
+}
+
+auto Expected(int64_t first, int64_t last) -> std::vector<int64_t> {
+  std::vector<int64_t> keys;
+  for (int64_t key = first; key <= last; key += 2) {
+    keys.push_back(key);
+  }
+  return keys;
+}
+
+auto ExpectedReverse(int64_t first, int64_t last) -> std::vector<int64_t> {
+  auto keys = Expected(first, last);
+  std::reverse(keys.begin(), keys.end());
+  return keys;
+}
+
+}  // namespace
+
+TEST(BPlusTreeTests, RangeScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 4, 5);
+
+  EXPECT_TRUE(ScanAll(&tree, std::nullopt, true, std::nullopt, true).empty());
+
+  // Even keys 2..1000, the RID slot holds the key.
+  for (int64_t key = 2; key <= 1000; key += 2) {
+    ASSERT_TRUE(tree.Insert(MakeKey(key), RID(0, key)));
+  }
+
+  EXPECT_EQ(ScanAll(&tree, std::nullopt, true, std::nullopt, true), Expected(2, 1000));
+  EXPECT_EQ(ScanAll(&tree, 100, true, 200, true), Expected(100, 200));
+  EXPECT_EQ(ScanAll(&tree, 100, false, 200, false), Expected(102, 198));
+  // Bounds between keys.
+  EXPECT_EQ(ScanAll(&tree, 99, false, 201, false), Expected(100, 200));
+  EXPECT_EQ(ScanAll(&tree, 99, true, 201, true), Expected(100, 200));
+  // Open ends.
+  EXPECT_EQ(ScanAll(&tree, std::nullopt, true, 11, true), Expected(2, 10));
+  EXPECT_EQ(ScanAll(&tree, 991, true, std::nullopt, true), Expected(992, 1000));
+  // Single keys and empty ranges.
+  EXPECT_EQ(ScanAll(&tree, 500, true, 500, true), Expected(500, 500));
+  EXPECT_TRUE(ScanAll(&tree, 500, false, 500, true).empty());
+  EXPECT_TRUE(ScanAll(&tree, 501, true, 501, true).empty());
+  EXPECT_TRUE(ScanAll(&tree, 200, true, 100, true).empty());
+  EXPECT_TRUE(ScanAll(&tree, 1000, false, std::nullopt, true).empty());
+  EXPECT_TRUE(ScanAll(&tree, std::nullopt, true, 2, false).empty());
+
+  // Stopping early is just not asking for more; the scan can be resumed where it left off.
+  KeyRangeScan<GenericKey<8>> scan;
+  scan.lower_ = MakeKey(300);
+  std::vector<RID> batch;
+  ASSERT_TRUE(tree.ScanRange(&scan, &batch));
+  EXPECT_EQ(batch[0].GetSlotNum(), 300);
+  for (int64_t key = 300; key <= 1000; key += 2) {
+    tree.Remove(MakeKey(key), nullptr);
+  }
+  batch.clear();
+  EXPECT_FALSE(tree.ScanRange(&scan, &batch));
+  EXPECT_TRUE(batch.empty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, ReverseRangeScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 4, 5);
+
+  EXPECT_TRUE(ScanAll(&tree, std::nullopt, true, std::nullopt, true, true).empty());
+
+  for (int64_t key = 2; key <= 1000; key += 2) {
+    ASSERT_TRUE(tree.Insert(MakeKey(key), RID(0, key)));
+  }
+
+  EXPECT_EQ(ScanAll(&tree, std::nullopt, true, std::nullopt, true, true), ExpectedReverse(2, 1000));
+  EXPECT_EQ(ScanAll(&tree, 100, true, 200, true, true), ExpectedReverse(100, 200));
+  EXPECT_EQ(ScanAll(&tree, 100, false, 200, false, true), ExpectedReverse(102, 198));
+  EXPECT_EQ(ScanAll(&tree, 99, false, 201, false, true), ExpectedReverse(100, 200));
+  EXPECT_EQ(ScanAll(&tree, std::nullopt, true, 11, true, true), ExpectedReverse(2, 10));
+  EXPECT_EQ(ScanAll(&tree, 991, true, std::nullopt, true, true), ExpectedReverse(992, 1000));
+  EXPECT_EQ(ScanAll(&tree, 500, true, 500, true, true), ExpectedReverse(500, 500));
+  EXPECT_TRUE(ScanAll(&tree, 500, false, 500, true, true).empty());
+  EXPECT_TRUE(ScanAll(&tree, 200, true, 100, true, true).empty());
+  EXPECT_TRUE(ScanAll(&tree, std::nullopt, true, 2, false, true).empty());
+
+  // An exclusive upper bound on every key, including the ones that are also separators.
+  for (int64_t upper = 6; upper <= 1000; upper += 2) {
+    ASSERT_EQ(ScanAll(&tree, upper - 4, true, upper, false, true), ExpectedReverse(upper - 4, upper - 2));
+  }
+
+  // Holes left by removes are skipped.
+  for (int64_t key = 100; key <= 900; key += 2) {
+    tree.Remove(MakeKey(key), nullptr);
+  }
+  auto keys = ExpectedReverse(902, 1000);
+  auto low_keys = ExpectedReverse(2, 98);
+  keys.insert(keys.end(), low_keys.begin(), low_keys.end());
+  EXPECT_EQ(ScanAll(&tree, std::nullopt, true, std::nullopt, true, true), keys);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+}  // namespace bustub
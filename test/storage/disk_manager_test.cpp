@@ -10,7 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
+#include <unistd.h>
 #include <cstring>
+#include <filesystem>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
@@ -55,6 +60,214 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIOReadWritePageTest) {
+  // one byte off, so that direct I/O has to go through the bounce buffer
+  alignas(BUSTUB_PAGE_SIZE) char buf[BUSTUB_PAGE_SIZE + 1] = {0};
+  alignas(BUSTUB_PAGE_SIZE) char data[BUSTUB_PAGE_SIZE + 1] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file, true);
+  std::strncpy(data + 1, "A test string.", BUSTUB_PAGE_SIZE);
+
+  dm.WritePage(0, data);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, data, BUSTUB_PAGE_SIZE), 0);
+
+  dm.WritePage(3, data + 1);
+  dm.ReadPage(3, buf + 1);
+  EXPECT_EQ(std::memcmp(buf + 1, data + 1, BUSTUB_PAGE_SIZE), 0);
+
+  // Scenario: reading past the end of the file yields a zeroed page.
+  dm.ReadPage(10, buf);
+  EXPECT_EQ(0, buf[0]);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ConcurrentReadWritePageTest) {
+  const int num_threads = 4;
+  const int pages_per_thread = 100;
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  // Scenario: threads reading and writing different pages do not see each other's data.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&dm, tid] {
+      char buf[BUSTUB_PAGE_SIZE] = {0};
+      char data[BUSTUB_PAGE_SIZE] = {0};
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = i * num_threads + tid;
+        snprintf(data, sizeof(data), "page %d", page_id);
+        dm.WritePage(page_id, data);
+        dm.ReadPage(page_id, buf);
+        EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * pages_per_thread, dm.GetNumWrites());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AllocatePageTest) {
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  for (page_id_t i = 0; i < 10; i++) {
+    EXPECT_EQ(i, dm.AllocatePage());
+  }
+
+  // Scenario: deallocated pages are reused lowest first before the file grows.
+  dm.DeallocatePage(5);
+  dm.DeallocatePage(3);
+  dm.DeallocatePage(3);
+  EXPECT_FALSE(dm.IsAllocated(3));
+  EXPECT_EQ(3, dm.AllocatePage());
+  EXPECT_EQ(5, dm.AllocatePage());
+  EXPECT_EQ(10, dm.AllocatePage());
+
+  // Scenario: a strided allocation only hands out pages of its residue.
+  dm.DeallocatePage(4);
+  dm.DeallocatePage(7);
+  dm.DeallocatePage(8);
+  EXPECT_EQ(4, dm.AllocatePage(3, 1));
+  EXPECT_EQ(7, dm.AllocatePage(3, 1));
+  EXPECT_EQ(13, dm.AllocatePage(3, 1));
+  EXPECT_EQ(8, dm.AllocatePage());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePageMapTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+  // more pages than one map page covers
+  const page_id_t num_pages = BUSTUB_PAGE_SIZE * 8 + 100;
+
+  {
+    auto dm = DiskManager(db_file);
+    for (page_id_t i = 0; i < num_pages; i++) {
+      ASSERT_EQ(i, dm.AllocatePage());
+    }
+    for (page_id_t i = 10; i < 20; i++) {
+      dm.DeallocatePage(i);
+    }
+    dm.DeallocatePage(30);
+    dm.DeallocatePage(num_pages - 50);
+    dm.WritePage(0, data);
+    dm.WritePage(num_pages - 1, data);
+
+    auto fragmentation = dm.GetFragmentation();
+    EXPECT_EQ(num_pages, fragmentation.num_pages_);
+    EXPECT_EQ(12, fragmentation.num_free_pages_);
+    EXPECT_EQ(3, fragmentation.num_free_runs_);
+    EXPECT_EQ(10, fragmentation.largest_free_run_);
+    dm.ShutDown();
+  }
+
+  // Scenario: the free page map survives reopening the file, and the map pages do not clobber data pages.
+  auto dm = DiskManager(db_file);
+  EXPECT_TRUE(dm.IsAllocated(0));
+  EXPECT_FALSE(dm.IsAllocated(15));
+  EXPECT_TRUE(dm.IsAllocated(num_pages - 1));
+  EXPECT_FALSE(dm.IsAllocated(num_pages));
+  EXPECT_EQ(12, dm.GetFragmentation().num_free_pages_);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  dm.ReadPage(num_pages - 1, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  EXPECT_EQ(10, dm.AllocatePage());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CrashFreePageMapTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  // Scenario: a copy of the file taken while the disk manager is still open, i.e. without ShutDown() writing the map,
+  // still has every written page allocated.
+  {
+    auto dm = DiskManager(db_file);
+    for (page_id_t i = 0; i < 3; i++) {
+      ASSERT_EQ(i, dm.AllocatePage());
+    }
+    dm.WritePage(1, data);
+    std::filesystem::copy_file(db_file, "test_crash.db", std::filesystem::copy_options::overwrite_existing);
+    dm.ShutDown();
+  }
+  {
+    auto dm = DiskManager("test_crash.db");
+    EXPECT_TRUE(dm.IsAllocated(1));
+    EXPECT_NE(1, dm.AllocatePage());
+    dm.ShutDown();
+  }
+  remove("test_crash.db");
+  remove("test_crash.log");
+
+  // Scenario: a file larger than 2 GiB, whose size does not fit an int, keeps its map.
+  int fd = open(db_file.c_str(), O_RDWR);
+  ASSERT_NE(-1, fd);
+  ASSERT_EQ(0, ftruncate(fd, static_cast<off_t>(3) << 30));
+  close(fd);
+  auto dm = DiskManager(db_file);
+  EXPECT_TRUE(dm.IsAllocated(2));
+  EXPECT_EQ(3, dm.AllocatePage());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, IOErrorTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+  auto dm = DiskManager(db_file);
+  dm.WritePage(0, data);
+  dm.WritePage(1, data);
+
+  // Scenario: a page past the end of the file reads as zeros, but a page the file ends inside of is an error.
+  int fd = open(db_file.c_str(), O_RDWR);
+  ASSERT_NE(-1, fd);
+  // the header page, the first map page, page 0 and half of page 1
+  ASSERT_EQ(0, ftruncate(fd, 3 * BUSTUB_PAGE_SIZE + BUSTUB_PAGE_SIZE / 2));
+  close(fd);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  EXPECT_THROW(dm.ReadPage(1, buf), Exception);
+  buf[0] = 'x';
+  dm.ReadPage(2, buf);
+  EXPECT_EQ(0, buf[0]);
+
+  // Scenario: reads and writes that fail throw.
+  dm.ShutDown();
+  EXPECT_THROW(dm.ReadPage(0, buf), Exception);
+  EXPECT_THROW(dm.WritePage(0, data), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, RejectOldFormatTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  // Scenario: a file written without the header, e.g. one whose page 0 lives at offset 0, is refused.
+  int fd = open("test.db", O_RDWR | O_CREAT, 0644);
+  ASSERT_NE(-1, fd);
+  ASSERT_EQ(BUSTUB_PAGE_SIZE, pwrite(fd, data, BUSTUB_PAGE_SIZE, 0));
+  close(fd);
+  EXPECT_THROW(DiskManager("test.db"), Exception);
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
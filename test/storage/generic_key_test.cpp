@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key_test.cpp
+//
+// Identification: test/storage/generic_key_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+template <size_t KeySize>
+auto MakeKey(const std::vector<Value> &values, const Schema &key_schema) -> GenericKey<KeySize> {
+  GenericKey<KeySize> key;
+  key.SetFromKey(Tuple(values, &key_schema), key_schema);
+  return key;
+}
+
+// Checks that the keys of rows, listed in increasing order, compare like the rows and decode back to them.
+template <size_t KeySize>
+void CheckOrder(const std::vector<std::vector<Value>> &rows, Schema *key_schema) {
+  GenericComparator<KeySize> comparator(key_schema);
+  for (size_t i = 0; i < rows.size(); i++) {
+    auto key = MakeKey<KeySize>(rows[i], *key_schema);
+    for (uint32_t column = 0; column < key_schema->GetColumnCount(); column++) {
+      Value value = key.ToValue(key_schema, column);
+      if (rows[i][column].IsNull()) {
+        EXPECT_TRUE(value.IsNull()) << "row " << i;
+      } else {
+        EXPECT_EQ(value.CompareEquals(rows[i][column]), CmpBool::CmpTrue) << "row " << i;
+      }
+    }
+    for (size_t j = 0; j < rows.size(); j++) {
+      int expected = (i > j) - (i < j);
+      EXPECT_EQ(comparator(key, MakeKey<KeySize>(rows[j], *key_schema)), expected) << "rows " << i << ", " << j;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(GenericKeyTest, IntegerColumnsTest) {
+  auto key_schema = ParseCreateStatement("a integer,b integer");
+  std::vector<int32_t> numbers = {BUSTUB_INT32_MIN, -65536, -256, -1, 0, 1, 255, 256, 65536, BUSTUB_INT32_MAX};
+  std::vector<std::vector<Value>> rows;
+  for (auto a : numbers) {
+    for (auto b : numbers) {
+      rows.push_back({ValueFactory::GetIntegerValue(a), ValueFactory::GetIntegerValue(b)});
+    }
+  }
+  // NULLs sort before every value.
+  rows.insert(rows.begin(), {ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetIntegerValue(0)});
+  CheckOrder<8>(rows, key_schema.get());
+}
+
+TEST(GenericKeyTest, MixedColumnsTest) {
+  auto key_schema = ParseCreateStatement("a varchar(16),b double,c smallint");
+  std::vector<std::vector<Value>> rows;
+  std::vector<std::string> strings = {"", std::string("\0", 1), std::string("\0z", 2), "a", std::string("a\0", 2),
+                                      "ab", "b"};
+  for (const auto &a : strings) {
+    for (double b : {-2.5, -0.5, 0.0, 0.5, 1e10}) {
+      for (int16_t c : {-1, 7}) {
+        rows.push_back({ValueFactory::GetVarcharValue(a), ValueFactory::GetDecimalValue(b),
+                        ValueFactory::GetSmallIntValue(c)});
+      }
+    }
+  }
+  rows.insert(rows.begin(), {ValueFactory::GetNullValueByType(TypeId::VARCHAR), ValueFactory::GetDecimalValue(3),
+                             ValueFactory::GetSmallIntValue(0)});
+  CheckOrder<64>(rows, key_schema.get());
+}
+
+TEST(GenericKeyTest, NullSentinelTest) {
+  // A NULL decimal is its sentinel, so that no number decodes to NULL, not even the one closest to the sentinel.
+  auto key_schema = ParseCreateStatement("a double,b integer");
+  std::vector<std::vector<Value>> rows;
+  for (double a : {std::nextafter(BUSTUB_DECIMAL_NULL, 0.0), -1.0, 0.0, 1.0, std::numeric_limits<double>::max()}) {
+    rows.push_back({ValueFactory::GetDecimalValue(a), ValueFactory::GetNullValueByType(TypeId::INTEGER)});
+    rows.push_back({ValueFactory::GetDecimalValue(a), ValueFactory::GetIntegerValue(0)});
+  }
+  rows.insert(rows.begin(), {ValueFactory::GetNullValueByType(TypeId::DECIMAL), ValueFactory::GetIntegerValue(0)});
+  CheckOrder<16>(rows, key_schema.get());
+}
+
+TEST(GenericKeyTest, IntegerForTestTest) {
+  GenericComparator<8> comparator(nullptr);
+  GenericKey<8> lhs;
+  GenericKey<8> rhs;
+  for (int64_t a : {-(int64_t{1} << 40), int64_t{-1}, int64_t{0}, int64_t{1}, int64_t{1} << 40}) {
+    lhs.SetFromInteger(a);
+    EXPECT_EQ(lhs.ToString(), a);
+    for (int64_t b : {int64_t{-300}, int64_t{0}, int64_t{300}}) {
+      rhs.SetFromInteger(b);
+      EXPECT_EQ(comparator(lhs, rhs), (a > b) - (a < b));
+    }
+  }
+}
+
+}  // namespace bustub
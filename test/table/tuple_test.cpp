@@ -11,16 +11,23 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <iostream>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -61,4 +68,110 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+/** Records how often every page is read. */
+class ReadCountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    {
+      std::scoped_lock lock(latch_);
+      reads_[page_id]++;
+    }
+    num_reads_++;
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  auto GetReads() -> std::unordered_map<page_id_t, size_t> {
+    std::scoped_lock lock(latch_);
+    return reads_;
+  }
+
+  std::atomic<size_t> num_reads_{0};
+
+ private:
+  std::mutex latch_;
+  std::unordered_map<page_id_t, size_t> reads_;
+};
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapReadAheadTest) {
+  const size_t buffer_pool_size = 64;
+  const int num_tuples = 2000;
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 200}}};
+  std::string padding(200, 'x');
+
+  auto disk_manager = std::make_unique<ReadCountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(padding)}, &schema};
+    ASSERT_TRUE(table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple).has_value());
+  }
+  // the table is larger than the pool, so its first pages have been evicted
+  ASSERT_EQ(0, disk_manager->num_reads_);
+
+  // Scenario: creating the iterator reads the first page and starts reading the pages after it in the background.
+  auto iter = table->MakeIterator();
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (disk_manager->num_reads_ < 1 + READ_AHEAD_PAGES && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(1 + READ_AHEAD_PAGES, disk_manager->num_reads_);
+
+  // Scenario: the scan sees every tuple in order, and no page is read twice.
+  int expected = 0;
+  for (; !iter.IsEnd(); ++iter) {
+    auto [meta, tuple] = iter.GetTuple();
+    ASSERT_EQ(expected, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    expected++;
+  }
+  EXPECT_EQ(num_tuples, expected);
+  for (auto [page_id, reads] : disk_manager->GetReads()) {
+    EXPECT_EQ(1, reads) << "page " << page_id;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapInterleavedReadAheadTest) {
+  const size_t buffer_pool_size = 64;
+  const int num_tuples = 2000;
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 200}}};
+  std::string padding(200, 'x');
+
+  auto disk_manager = std::make_unique<ReadCountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  std::vector<std::unique_ptr<TableHeap>> tables;
+  for (int t = 0; t < 2; t++) {
+    tables.push_back(std::make_unique<TableHeap>(bpm.get()));
+    for (int i = 0; i < num_tuples; i++) {
+      Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(padding)}, &schema};
+      ASSERT_TRUE(tables[t]->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple).has_value());
+    }
+  }
+
+  // Scenario: two scans that take turns keep their read-ahead windows in their own rings, so neither recycles the
+  // pages the other prefetched and every page is still read only once.
+  std::vector<TableIterator> iters;
+  iters.push_back(tables[0]->MakeIterator());
+  iters.push_back(tables[1]->MakeIterator());
+  // making an iterator reads the last page of the table outside the scan, if it was evicted
+  auto reads_before = disk_manager->GetReads();
+  std::vector<int> expected(2, 0);
+  while (!iters[0].IsEnd() || !iters[1].IsEnd()) {
+    for (size_t t = 0; t < 2; t++) {
+      if (iters[t].IsEnd()) {
+        continue;
+      }
+      auto [meta, tuple] = iters[t].GetTuple();
+      ASSERT_EQ(expected[t], tuple.GetValue(&schema, 0).GetAs<int32_t>());
+      expected[t]++;
+      ++iters[t];
+    }
+  }
+  EXPECT_EQ(num_tuples, expected[0]);
+  EXPECT_EQ(num_tuples, expected[1]);
+  for (auto [page_id, reads] : disk_manager->GetReads()) {
+    EXPECT_LE(reads - reads_before[page_id], 1) << "page " << page_id;
+  }
+}
+
 }  // namespace bustub
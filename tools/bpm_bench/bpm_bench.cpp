@@ -14,6 +14,7 @@
 #include "binder/binder.h"
 #include "buffer/buffer_pool_manager.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/util/string_util.h"
@@ -103,13 +104,20 @@ struct BpmMetrics {
 // NOLINTNEXTLINE
 auto main(int argc, char **argv) -> int {
   using bustub::AccessType;
+  using bustub::BufferAccessStrategy;
   using bustub::BufferPoolManager;
   using bustub::DiskManagerUnlimitedMemory;
   using bustub::page_id_t;
+  using bustub::ParallelBufferPoolManager;
 
   argparse::ArgumentParser program("bustub-bpm-bench");
   program.add_argument("--duration").help("run bpm bench for n milliseconds");
   program.add_argument("--latency").help("set disk latency to n milliseconds");
+  program.add_argument("--instances").help("split the buffer pool into n independent instances");
+  program.add_argument("--flusher")
+      .help("write dirty pages back in the background")
+      .default_value(false)
+      .implicit_value(true);
 
   try {
     program.parse_args(argc, argv);
@@ -129,12 +137,28 @@ auto main(int argc, char **argv) -> int {
     latency_ms = std::stoi(program.get("--latency"));
   }
 
+  uint64_t num_instances = 1;
+  if (program.present("--instances")) {
+    num_instances = std::stoi(program.get("--instances"));
+  }
+
+  bool use_flusher = program.get<bool>("--flusher");
+
   auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  std::unique_ptr<BufferPoolManager> bpm;
+  if (num_instances > 1) {
+    // keep the total number of frames the same, so the results are comparable with a single instance
+    bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, BUSTUB_BPM_SIZE / num_instances,
+                                                      disk_manager.get(), LRU_K_SIZE);
+  } else {
+    bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  }
   std::vector<page_id_t> page_ids;
 
-  fmt::print(stderr, "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}\n",
-             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  fmt::print(stderr,
+             "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}, bpm_instances={}, "
+             "bpm_flusher={}\n",
+             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE, num_instances, use_flusher);
 
   for (size_t i = 0; i < BUSTUB_PAGE_CNT; i++) {
     page_id_t page_id;
@@ -151,6 +175,9 @@ auto main(int argc, char **argv) -> int {
 
   // enable disk latency after creating all pages
   disk_manager->SetLatency(latency_ms);
+  if (use_flusher) {
+    bpm->StartBackgroundFlusher();
+  }
 
   fmt::print(stderr, "[info] benchmark start\n");
 
@@ -165,9 +192,10 @@ auto main(int argc, char **argv) -> int {
       metrics.Begin();
 
       size_t page_idx = BUSTUB_PAGE_CNT * thread_id / BUSTUB_SCAN_THREAD;
+      BufferAccessStrategy strategy;
 
       while (!metrics.ShouldFinish()) {
-        auto *page = bpm->FetchPage(page_ids[page_idx], AccessType::Scan);
+        auto *page = bpm->FetchPage(page_ids[page_idx], AccessType::Scan, &strategy);
         if (page == nullptr) {
           continue;
         }
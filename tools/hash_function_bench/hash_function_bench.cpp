@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "container/hash/hash_function.h"
+#include "fmt/format.h"
+#include "storage/index/generic_key.h"
+
+namespace {
+
+const size_t NUM_BUCKETS = 1024;
+const size_t THROUGHPUT_ROUNDS = 10;
+
+// Sequential integers, the keys a weak hash spreads worst.
+template <typename KeyType>
+auto MakeKeys(size_t num_keys) -> std::vector<KeyType> {
+  std::vector<KeyType> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    if constexpr (std::is_integral_v<KeyType>) {
+      keys[i] = static_cast<KeyType>(i);
+    } else {
+      keys[i].SetFromInteger(static_cast<int64_t>(i));
+    }
+  }
+  return keys;
+}
+
+// Chi-squared statistic over the degrees of freedom; close to 1 when the keys are spread uniformly.
+auto ChiSquared(const std::vector<size_t> &buckets, size_t num_keys) -> double {
+  double expected = static_cast<double>(num_keys) / buckets.size();
+  double sum = 0;
+  for (auto count : buckets) {
+    sum += (count - expected) * (count - expected) / expected;
+  }
+  return sum / (buckets.size() - 1);
+}
+
+template <typename KeyType, typename Hasher>
+void Bench(const std::string &hasher_name, const std::string &key_name, size_t num_keys) {
+  auto keys = MakeKeys<KeyType>(num_keys);
+  bustub::HashFunction<KeyType, Hasher> hash_fn;
+
+  uint64_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < THROUGHPUT_ROUNDS; round++) {
+    for (const auto &key : keys) {
+      checksum += hash_fn.GetHash(key);
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  double hashes_per_sec = num_keys * THROUGHPUT_ROUNDS / elapsed.count();
+
+  // The low bits pick directory slots and probe positions, the high bits header slots and block fingerprints.
+  std::vector<size_t> low_buckets(NUM_BUCKETS);
+  std::vector<size_t> high_buckets(NUM_BUCKETS);
+  for (const auto &key : keys) {
+    uint64_t hash = hash_fn.GetHash(key);
+    low_buckets[hash % NUM_BUCKETS]++;
+    high_buckets[hash >> 54]++;
+  }
+
+  fmt::print("{:<10} {:<14} {:>10.2f} Mhash/s {:>8.2f} ns/hash   chi2 low={:<6.3f} high={:<6.3f}  ({:x})\n",
+             hasher_name, key_name, hashes_per_sec / 1e6, 1e9 / hashes_per_sec, ChiSquared(low_buckets, num_keys),
+             ChiSquared(high_buckets, num_keys), checksum & 0xFFFF);
+}
+
+template <typename Hasher>
+void BenchAllKeys(const std::string &hasher_name, size_t num_keys) {
+  Bench<int, Hasher>(hasher_name, "int", num_keys);
+  Bench<bustub::GenericKey<8>, Hasher>(hasher_name, "GenericKey<8>", num_keys);
+  Bench<bustub::GenericKey<16>, Hasher>(hasher_name, "GenericKey<16>", num_keys);
+  Bench<bustub::GenericKey<64>, Hasher>(hasher_name, "GenericKey<64>", num_keys);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-hash-function-bench");
+  program.add_argument("--keys").help("number of keys to hash");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_keys = 1000000;
+  if (program.present("--keys")) {
+    num_keys = std::stoul(program.get("--keys"));
+  }
+
+  fmt::print(stderr, "[info] num_keys={}, rounds={}, buckets={}\n", num_keys, THROUGHPUT_ROUNDS, NUM_BUCKETS);
+  BenchAllKeys<bustub::MurmurHash3Hasher>("murmur3", num_keys);
+  BenchAllKeys<bustub::WyHasher>("wyhash", num_keys);
+  BenchAllKeys<bustub::Crc32cHasher>("crc32c", num_keys);
+  return 0;
+}